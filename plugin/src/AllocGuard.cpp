@@ -0,0 +1,55 @@
+//////////////////////////////////////////////////////////////////////////
+// AllocGuard – counting operator new/delete (VDJSYNC_ALLOC_GUARD only)
+//////////////////////////////////////////////////////////////////////////
+
+#include "AllocGuard.h"
+
+#ifdef VDJSYNC_ALLOC_GUARD
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local uint64_t t_allocations = 0;
+
+void* allocate(std::size_t size) {
+    ++t_allocations;
+    return std::malloc(size != 0 ? size : 1);
+}
+
+} // namespace
+
+uint64_t AllocCheck::threadAllocations() {
+    return t_allocations;
+}
+
+void AllocCheck::fail(const char* section, uint64_t allocations) {
+    std::fprintf(stderr, "VdjVideoSync: %llu heap allocation(s) in %s\n",
+                 static_cast<unsigned long long>(allocations), section);
+    std::fflush(stderr);
+    std::abort();
+}
+
+// The aligned forms keep their default pairing and are not counted;
+// nothing on the hot paths is over-aligned.
+void* operator new(std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](std::size_t size) {
+    if (void* p = allocate(size)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept   { return allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void operator delete(void* p) noexcept                              { std::free(p); }
+void operator delete[](void* p) noexcept                            { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept                 { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept               { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept       { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept     { std::free(p); }
+
+#endif // VDJSYNC_ALLOC_GUARD
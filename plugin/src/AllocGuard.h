@@ -0,0 +1,44 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// AllocGuard – catches heap allocations on the steady-state hot paths
+//
+// The poll tick (deck reads, mirror filter, budget, publish, fan-out
+// frame) and the sender's frame encode run many times a second and must
+// not touch the heap once running: DeckState is inline (see
+// FixedString.h), the mailboxes, encode buffer and fan-out frames are
+// preallocated.  An allocation that
+// creeps back in only shows up as jitter on a busy host, so a test
+// build can make it fail loudly instead.
+//
+// Configured with -DVDJSYNC_ALLOC_GUARD=ON, the plugin replaces the
+// global operator new/delete with counting versions (this module only;
+// VDJ keeps its own allocator), and AllocCheck::check() aborts with the
+// section name if the calling thread allocated since the check began.
+// Without the option AllocCheck compiles to nothing.  Never ship a
+// guard build; plugin/tests builds this way (AllocGuardTest).
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstdint>
+
+class AllocCheck {
+public:
+#ifdef VDJSYNC_ALLOC_GUARD
+    explicit AllocCheck(const char* section) : section_(section), start_(threadAllocations()) {}
+    void check() const {
+        uint64_t n = threadAllocations() - start_;
+        if (n != 0) fail(section_, n);
+    }
+
+    // Heap allocations made by the calling thread so far.
+    static uint64_t threadAllocations();
+
+private:
+    [[noreturn]] static void fail(const char* section, uint64_t allocations);
+
+    const char* section_;
+    uint64_t    start_;
+#else
+    explicit AllocCheck(const char*) {}
+    void check() const {}
+#endif
+};
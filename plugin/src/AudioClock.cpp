@@ -0,0 +1,116 @@
+//////////////////////////////////////////////////////////////////////////
+// AudioClock – implementation
+//////////////////////////////////////////////////////////////////////////
+
+#include "AudioClock.h"
+
+#include <cmath>
+#include <sstream>
+
+namespace {
+
+int64_t steadyUs(AudioClock::clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(t.time_since_epoch()).count();
+}
+
+} // namespace
+
+void AudioClock::onBlock(int frames, int sampleRate) {
+    if (frames <= 0) return;
+    int64_t now = steadyUs(clock::now());
+
+    // Seqlock write: the reader retries if seq changed under it.
+    uint32_t s = seq_.load(std::memory_order_relaxed);
+    seq_.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    blockStart_.store(total_, std::memory_order_relaxed);
+    blockUs_.store(now, std::memory_order_relaxed);
+    blockFrames_.store(frames, std::memory_order_relaxed);
+    rate_.store(sampleRate, std::memory_order_relaxed);
+    seq_.store(s + 2, std::memory_order_release);
+
+    total_ += static_cast<uint64_t>(frames);
+}
+
+bool AudioClock::update() {
+    uint64_t frame = 0;
+    int64_t  at = 0;
+    int32_t  frames = 0, rate = 0;
+    bool     read = false;
+    for (int tries = 0; tries < 4 && !read; ++tries) {
+        uint32_t s = seq_.load(std::memory_order_acquire);
+        if (s & 1) continue;
+        frame  = blockStart_.load(std::memory_order_relaxed);
+        at     = blockUs_.load(std::memory_order_relaxed);
+        frames = blockFrames_.load(std::memory_order_relaxed);
+        rate   = rate_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        read = seq_.load(std::memory_order_relaxed) == s && s != 0;
+    }
+    // A block in flux four times running means the audio thread is busy
+    // right now; the previous mapping is still good.
+    if (!read) return locked_ && running_.load();
+
+    if (rate <= 0 || steadyUs(clock::now()) - at > kStaleMs * 1000) {
+        locked_  = false;
+        running_ = false;
+        return false;
+    }
+
+    double blockDurUs = frames * 1e6 / rate;
+    if (!locked_ || rate != lockedRate_ || frame < baseFrame_) {
+        baseUs_ = static_cast<double>(at);
+        lockedRate_ = rate;
+        locked_ = true;
+        relocks_++;
+    } else {
+        double predicted = baseUs_ + static_cast<double>(frame - baseFrame_) * 1e6 / rate;
+        double err = static_cast<double>(at) - predicted;
+        if (err > 4 * blockDurUs) {
+            // Samples went missing (engine stall or device change): the
+            // old phase means nothing any more.
+            predicted = static_cast<double>(at);
+            relocks_++;
+        } else if (err < 0) {
+            predicted += err;              // early callback: the lock was late
+        } else {
+            predicted += err * kLockGain;  // late callback: mostly scheduler delay
+        }
+        baseUs_ = predicted;
+        int64_t jitter = jitterUs_.load();
+        jitterUs_ = jitter + (static_cast<int64_t>(std::fabs(err)) - jitter) / 16;
+    }
+    baseFrame_  = frame;
+    blockDurUs_ = blockDurUs;
+
+    statRate_  = rate;
+    statBlock_ = frames;
+    latencyUs_ = static_cast<int64_t>(blockDurUs);
+    running_   = true;
+    return true;
+}
+
+int64_t AudioClock::audibleUs() const {
+    return static_cast<int64_t>(baseUs_ + blockDurUs_);
+}
+
+AudioClock::clock::time_point AudioClock::nextBlockAfter(clock::time_point t) const {
+    double since = static_cast<double>(steadyUs(t)) - baseUs_;
+    double blocks = since > 0 ? std::ceil(since / blockDurUs_) : 0.0;
+    auto us = static_cast<int64_t>(baseUs_ + blocks * blockDurUs_) + kGuardUs;
+    return clock::time_point(std::chrono::duration_cast<clock::duration>(
+        std::chrono::microseconds(us)));
+}
+
+std::string AudioClock::statsJson() const {
+    std::ostringstream ss;
+    ss << "{"
+       << "\"running\":" << (running_.load() ? "true" : "false") << ","
+       << "\"sampleRate\":" << statRate_.load() << ","
+       << "\"blockFrames\":" << statBlock_.load() << ","
+       << "\"latencyUs\":" << latencyUs_.load() << ","
+       << "\"jitterUs\":" << jitterUs_.load() << ","
+       << "\"relocks\":" << relocks_.load()
+       << "}";
+    return ss.str();
+}
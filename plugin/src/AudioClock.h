@@ -0,0 +1,76 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// AudioClock – deck timing derived from the audio engine's sample clock
+//
+// OnProcessSamples() counts the samples VDJ hands the plugin and stamps
+// each block with the steady clock.  The poll tick turns those raw,
+// scheduler-jittered callback times into a smooth sample → time mapping
+// (a phase-locked loop that trusts early callbacks, since a callback can
+// be delayed but never runs before its audio is due) and uses it to
+//
+//   * timestamp deck reads with when the current block is heard: the
+//     block's smoothed start plus the output latency, i.e. the one block
+//     queued ahead of it in the device buffer;
+//   * wake just after the next block boundary, so every poll reads a
+//     freshly processed block instead of a free-running timer's phase.
+//
+// While no audio is processed (effect off the master, engine stopped)
+// update() returns false and callers fall back to the steady clock.
+//
+// onBlock() is called from the audio thread only; everything else from
+// the poll tick (scheduler thread), except statsJson() (any thread).
+//////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+class AudioClock {
+public:
+    using clock = std::chrono::steady_clock;
+
+    // Audio thread: one call per processed block.  Wait-free.
+    void onBlock(int frames, int sampleRate);
+
+    // Refreshes the mapping from the newest block.  False while no block
+    // has arrived within kStaleMs.
+    bool update();
+
+    // Valid after update() returned true.  Steady-clock time (µs) at
+    // which the newest block starts playing.
+    int64_t audibleUs() const;
+    // First block boundary at or after t, plus a margin for the engine
+    // to finish the block.
+    clock::time_point nextBlockAfter(clock::time_point t) const;
+
+    std::string statsJson() const;
+
+    static constexpr int64_t kStaleMs = 250;
+    static constexpr int64_t kGuardUs = 500;    // block processing margin
+    static constexpr double  kLockGain = 0.02;  // pull towards late callbacks per update
+
+private:
+    // ── Published by the audio thread (seqlock: odd seq = in flux) ──
+    std::atomic<uint32_t> seq_{0};
+    std::atomic<uint64_t> blockStart_{0};   // samples processed before the newest block
+    std::atomic<int64_t>  blockUs_{0};      // steady clock at its callback
+    std::atomic<int32_t>  blockFrames_{0};
+    std::atomic<int32_t>  rate_{0};
+    uint64_t              total_ = 0;       // audio thread only
+
+    // ── Poll tick ──
+    bool     locked_ = false;
+    uint64_t baseFrame_ = 0;     // anchor of the smoothed mapping
+    double   baseUs_ = 0.0;
+    int      lockedRate_ = 0;
+    double   blockDurUs_ = 0.0;
+
+    // ── Stats (written by the poll tick) ──
+    std::atomic<bool>     running_{false};
+    std::atomic<int32_t>  statRate_{0};
+    std::atomic<int32_t>  statBlock_{0};
+    std::atomic<int64_t>  latencyUs_{0};
+    std::atomic<int64_t>  jitterUs_{0};     // mean callback lateness vs. the lock
+    std::atomic<uint64_t> relocks_{0};
+};
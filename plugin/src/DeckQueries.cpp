@@ -0,0 +1,201 @@
+//////////////////////////////////////////////////////////////////////////
+// DeckQueries – implementation
+//////////////////////////////////////////////////////////////////////////
+
+#include "DeckQueries.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+namespace {
+
+const char* const kVerbText[DeckQueries::kVerbs] = {
+    "get_songlength",              // float, seconds
+    "is_audible",                  // bool
+    "play",                        // bool
+    "get_volume",                  // float 0.0-1.0
+    "get_time elapsed absolute",   // int, ms
+    "get_pitch_value",             // float, centered on 100%
+    "get_bpm",                     // float
+    "get_filename",
+    "get_title",
+    "get_artist",
+};
+
+const char* const kGlobalText[DeckQueries::kGlobals] = {
+    "crossfader",                  // float 0.0-1.0
+    "get_activedeck",              // int, the master deck
+};
+
+// How far a per-verb read may differ from the composite one of the same
+// tick (the deck keeps playing between the two).
+double tolerance(int verb) {
+    return verb == DeckQueries::Time ? 250.0 : 1e-3;
+}
+
+bool isSep(char c) { return c == '|' || c == '\0'; }
+
+bool matchWord(const char*& p, const char* word) {
+    size_t n = std::strlen(word);
+    for (size_t i = 0; i < n; ++i) {
+        if (std::tolower(static_cast<unsigned char>(p[i])) != word[i]) return false;
+    }
+    if (!isSep(p[n])) return false;
+    p += n;
+    return true;
+}
+
+// Parses one '|'-terminated field: a plain decimal number or a VDJ
+// boolean word.  Hand-rolled so a comma locale can't change it; any
+// other text (units, formatted times) rejects the field.
+bool parseField(const char*& p, double& out) {
+    if (matchWord(p, "on") || matchWord(p, "yes") || matchWord(p, "true"))   { out = 1.0; return true; }
+    if (matchWord(p, "off") || matchWord(p, "no") || matchWord(p, "false")) { out = 0.0; return true; }
+
+    bool neg = *p == '-';
+    if (neg) ++p;
+    double v = 0.0, scale = 0.0;
+    int digits = 0;
+    for (; !isSep(*p); ++p) {
+        if (std::isdigit(static_cast<unsigned char>(*p))) {
+            if (scale > 0.0) { v += (*p - '0') * scale; scale /= 10.0; }
+            else             { v = v * 10.0 + (*p - '0'); }
+            ++digits;
+        } else if (*p == '.' && scale == 0.0) {
+            scale = 0.1;
+        } else {
+            return false;
+        }
+    }
+    if (digits == 0) return false;
+    out = neg ? -v : v;
+    return true;
+}
+
+} // namespace
+
+void DeckQueries::compile(int decks) {
+    if (composite_.empty()) {
+        for (int d = 0; d < kMaxDecks; ++d) {
+            for (int v = 0; v < kVerbs; ++v) {
+                std::snprintf(queries_[d][v], kQuerySize, "deck %d %s", d + 1, kVerbText[v]);
+            }
+        }
+        composite_.reserve(16 + kMaxDecks * kNumeric * (kQuerySize + 3) + kGlobals * 32);
+    }
+    decks_ = decks < kMaxDecks ? decks : kMaxDecks;
+    composite_ = "get_text \"";
+    for (int d = 0; d < decks_; ++d) {
+        for (int v = 0; v < kNumeric; ++v) {
+            if (d > 0 || v > 0) composite_ += '|';
+            composite_ += '`';
+            composite_ += queries_[d][v];
+            composite_ += '`';
+        }
+    }
+    for (int g = 0; g < kGlobals; ++g) {
+        composite_ += "|`";
+        composite_ += kGlobalText[g];
+        composite_ += '`';
+    }
+    composite_ += '"';
+}
+
+bool DeckQueries::number(int deck, Verb verb, double& out) {
+    calls_++;
+    return vdj_.GetInfo(queries_[deck - 1][verb], &out) == S_OK;
+}
+
+bool DeckQueries::text(int deck, Verb verb, char* buf, int size) {
+    calls_++;
+    std::memset(buf, 0, size);
+    return vdj_.GetStringInfo(queries_[deck - 1][verb], buf, size) == S_OK;
+}
+
+// The fader is there whether or not a track is loaded.
+bool DeckQueries::exists(int deck) {
+    double unused = 0.0;
+    return number(deck, Volume, unused);
+}
+
+bool DeckQueries::global(Global verb, double& out) {
+    calls_++;
+    return vdj_.GetInfo(kGlobalText[verb], &out) == S_OK;
+}
+
+bool DeckQueries::batch(int64_t nowUs, double out[][kNumeric], double globals[kGlobals]) {
+    if (disabled_ || decks_ == 0) return false;
+    if (!verified_ && nowUs < nextVerifyUs_) return false;
+
+    calls_++;
+    bool ok = vdj_.GetStringInfo(composite_.c_str(), result_, sizeof(result_)) == S_OK;
+    const char* p = result_;
+    int fields = decks_ * kNumeric + kGlobals;
+    for (int i = 0; ok && i < fields; ++i) {
+        double& field = i < decks_ * kNumeric ? out[i / kNumeric][i % kNumeric]
+                                              : globals[i - decks_ * kNumeric];
+        ok = parseField(p, field) && *p == (i == fields - 1 ? '\0' : '|');
+        if (ok && *p) ++p;
+    }
+    // Verified or not, one bad result (e.g. a deck mid-load) does not
+    // condemn the composite form; until it is verified, the retries are
+    // paced like the verification attempts.
+    if (!verified_) nextVerifyUs_ = nowUs + kVerifyIntervalUs;
+    if (!ok) {
+        batchFailures_++;
+        if (++failures_ >= kMaxBatchFailures) {
+            disabled_ = true;
+            batchActive_ = false;
+        }
+        return false;
+    }
+    failures_ = 0;
+
+    if (!verified_ && !verify(out, globals)) return false;
+    batchReads_++;
+    return true;
+}
+
+// Compares a composite result with per-verb reads.  Only a tick with a
+// track loaded proves anything (an empty deck reads all zeros either
+// way); until then the caller keeps reading verb by verb.
+bool DeckQueries::verify(const double batch[][kNumeric], const double globals[kGlobals]) {
+    bool loaded = false;
+    for (int d = 0; d < decks_; ++d) loaded = loaded || batch[d][Length] > 0.0;
+    if (!loaded) return false;
+
+    for (int d = 0; d < decks_; ++d) {
+        for (int v = 0; v < kNumeric; ++v) {
+            double single = 0.0;
+            if (!number(d + 1, static_cast<Verb>(v), single)) continue;
+            if (std::fabs(single - batch[d][v]) > tolerance(v)) {
+                disabled_ = true;
+                return false;
+            }
+        }
+    }
+    for (int g = 0; g < kGlobals; ++g) {
+        double single = 0.0;
+        if (!global(static_cast<Global>(g), single)) continue;
+        if (std::fabs(single - globals[g]) > 1e-3) {
+            disabled_ = true;
+            return false;
+        }
+    }
+    verified_ = true;
+    batchActive_ = true;
+    return true;
+}
+
+std::string DeckQueries::statsJson() const {
+    std::ostringstream ss;
+    ss << "{"
+       << "\"active\":" << (batchActive_.load() ? "true" : "false") << ","
+       << "\"reads\":" << batchReads_.load() << ","
+       << "\"failures\":" << batchFailures_.load()
+       << "}";
+    return ss.str();
+}
@@ -0,0 +1,88 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// DeckQueries – precompiled VDJ deck queries, batched where possible
+//
+// Every "deck N verb" string, for every deck up to kMaxDecks so that
+// exists() can look past the decks in use, is built once in compile()
+// instead of with snprintf on every read.  The numeric verbs of the
+// decks in use, followed by the mixer-wide ones, are also joined into
+// one composite script,
+//
+//   get_text "`deck 1 get_songlength`|`deck 1 is_audible`|...|`deck 4 get_bpm`|`crossfader`|`get_activedeck`"
+//
+// which the host evaluates in a single GetStringInfo() call; the result
+// is parsed in place (locale-independent, no allocation).
+//
+// The composite form depends on how the host renders each value as
+// text, so it is only trusted once it has matched the per-verb reads on
+// a tick with a track loaded.  Until then, and for good after a mismatch
+// or repeated parse failures, batch() returns false and callers read
+// verb by verb.
+//
+// Used from the poll tick only, except the counters.
+//////////////////////////////////////////////////////////////////////////
+
+#include "vdjPlugin8.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+class DeckQueries {
+public:
+    // Numeric verbs first: they make up the composite query.
+    enum Verb {
+        Length, Audible, Play, Volume, Time, Pitch, Bpm,
+        kNumeric,
+        Filename = kNumeric, Title, Artist,
+        kVerbs
+    };
+    // Mixer-wide numeric verbs, after the decks in the composite query.
+    enum Global { Crossfader, ActiveDeck, kGlobals };
+    static constexpr int kMaxDecks = 8;
+
+    DeckQueries(IVdjPlugin8& vdj, std::atomic<uint64_t>& calls) : vdj_(vdj), calls_(calls) {}
+
+    // Builds the composite query for decks 1..decks.  Allocates only on
+    // the first call, so the deck count can change from the poll tick.
+    void compile(int decks);
+
+    // Whether the host has deck `deck` in its layout: it answers a deck
+    // verb for it.  One host call (counted).
+    bool exists(int deck);
+
+    // One host call each (counted).
+    bool number(int deck, Verb verb, double& out);
+    bool text(int deck, Verb verb, char* buf, int size);
+    bool global(Global verb, double& out);
+
+    // Every numeric verb of every deck plus the globals, in one host call
+    // once verified.  out[d][v] is deck d+1, verb v.  False when the
+    // caller must read verb by verb instead.
+    bool batch(int64_t nowUs, double out[][kNumeric], double globals[kGlobals]);
+
+    std::string statsJson() const;
+
+    static constexpr int     kMaxBatchFailures = 3;          // in a row, then per-verb for good
+    static constexpr int64_t kVerifyIntervalUs = 1000000;    // between verification attempts
+
+private:
+    bool verify(const double batch[][kNumeric], const double globals[kGlobals]);
+
+    static constexpr int kQuerySize = 48;
+
+    IVdjPlugin8&           vdj_;
+    std::atomic<uint64_t>& calls_;
+    int                    decks_ = 0;
+    char                   queries_[kMaxDecks][kVerbs][kQuerySize] = {};
+    std::string            composite_;
+    char                   result_[2048] = {};
+    bool                   verified_ = false;
+    bool                   disabled_ = false;
+    int                    failures_ = 0;       // consecutive
+    int64_t                nextVerifyUs_ = 0;
+
+    std::atomic<uint64_t>  batchReads_{0};
+    std::atomic<uint64_t>  batchFailures_{0};
+    std::atomic<bool>      batchActive_{false};  // verified and not disabled
+};
@@ -0,0 +1,175 @@
+//////////////////////////////////////////////////////////////////////////
+// FanoutEndpoint – implementation
+//////////////////////////////////////////////////////////////////////////
+
+#include "FanoutEndpoint.h"
+
+#include <chrono>
+#include <sstream>
+
+FanoutEndpoint::~FanoutEndpoint() {
+    stop();
+}
+
+void FanoutEndpoint::configure(const std::string& host, const std::string& port, int maxHz) {
+    {
+        std::lock_guard<std::mutex> lock(nameMu_);
+        std::string name = host.empty() ? std::string() : host + ":" + port;
+        if (name != name_) {
+            name_ = name;
+            link_.setEndpoint(host, port, Transport::Http);
+        }
+    }
+    minIntervalMs_ = maxHz > 0 ? 1000 / maxHz : 0;
+    enabled_ = !host.empty();
+}
+
+void FanoutEndpoint::start() {
+    if (running_.load()) return;
+    running_ = true;
+    link_.resume();
+    exited_ = false;
+    thread_ = std::thread(&FanoutEndpoint::run, this);
+}
+
+// Returns within a few milliseconds even with a request in flight: the
+// link is cancelled until the thread is out (see stopWorker()).
+void FanoutEndpoint::stop() {
+    running_ = false;
+    {
+        std::lock_guard<std::mutex> lock(wakeMu_);
+        pending_ = true;
+    }
+    wakeCv_.notify_one();
+    if (!thread_.joinable()) return;
+    while (!exited_.load()) {
+        link_.cancel();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    thread_.join();
+}
+
+void FanoutEndpoint::publish(const Frame& frame, int decks) {
+    if (!enabled_.load()) return;
+    decks_ = decks;
+    if (slot_.publish(frame)) coalesced_++;
+    published_++;
+    {
+        std::lock_guard<std::mutex> lock(wakeMu_);
+        pending_ = true;
+    }
+    wakeCv_.notify_one();
+}
+
+void FanoutEndpoint::run() {
+    using clock = ServerLink::clock;
+    auto nextSend = clock::now();
+    bool resend = false;  // the last post failed with the link still up
+
+    while (running_.load()) {
+        // Wait for a frame and, when rate limited, for the next send slot;
+        // frames published meanwhile coalesce in the mailbox.  A failed
+        // frame is retried even if no newer one comes.
+        {
+            std::unique_lock<std::mutex> lock(wakeMu_);
+            auto wake = [this] { return pending_ || !running_.load(); };
+            if (resend) {
+                auto retry = clock::now() + std::chrono::milliseconds(kResendRetryMs);
+                wakeCv_.wait_until(lock, retry, wake);
+            } else {
+                wakeCv_.wait(lock, wake);
+            }
+            if (running_.load() && nextSend > clock::now()) {
+                wakeCv_.wait_until(lock, nextSend, [this] { return !running_.load(); });
+            }
+            pending_ = false;
+        }
+        if (!running_.load()) break;
+        if (!enabled_.load()) continue;
+
+        // While the server is down frames stay in the mailbox; retry at
+        // the link's pace.
+        up_ = link_.ensureConnected();
+        if (!up_.load()) {
+            std::unique_lock<std::mutex> lock(wakeMu_);
+            wakeCv_.wait_until(lock, link_.retryAt(), [this] { return !running_.load(); });
+            pending_ = true;
+            continue;
+        }
+
+        // After a reconnect the server may have missed frames, and after a
+        // failed post it did not take the newest one: resend it even if
+        // nothing changed since.
+        const Frame* frame = slot_.take();
+        bool reconnected = link_.epoch() != linkEpoch_;
+        if (reconnected) decksReported_ = 0;  // a restarted server assumes the default layout
+        if (!frame && (resend || reconnected)) frame = slot_.last();
+        linkEpoch_ = link_.epoch();
+        if (!frame || !*frame) continue;
+
+        // The server accepts decks up to the count it was last told:
+        // report more decks before the frame that needs them, fewer after
+        // the frame that empties the decks that went away.
+        int decks = decks_.load();
+        if (decks > decksReported_) reportDecks(decks);
+
+        auto start = clock::now();
+        int status = link_.post("/api/deck/batch", **frame, "application/json");
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+
+        if (decks < decksReported_) reportDecks(decks);
+
+        // An endpoint without /api/deck/batch (404, 405) fails every
+        // retry alike: wait for the next frame instead.  A deck count the
+        // server did not take is retried with the frame it bounds.
+        resend = ((status < 200 || status >= 300) && status != 404 && status != 405) ||
+                 decks != decksReported_;
+        if (status >= 200 && status < 300) {
+            sent_++;
+            consecutiveFailures_ = 0;
+            lastSendUs_ = us;
+            totalSendUs_ += us;
+            if (us > maxSendUs_.load()) maxSendUs_ = us;
+        } else {
+            failed_++;
+            consecutiveFailures_++;
+            up_ = link_.isUp();
+        }
+        nextSend = start + std::chrono::milliseconds(minIntervalMs_.load());
+    }
+    exited_ = true;
+}
+
+// Tells the server the host's deck count.  A server without
+// /api/plugin/stats (404, 405) accepts its default layout only, and
+// asking again would not change that.
+void FanoutEndpoint::reportDecks(int decks) {
+    std::string body = "{\"decks\":" + std::to_string(decks) + "}";
+    int status = link_.post("/api/plugin/stats", body, "application/json", nullptr,
+                            RequestKind::Background);
+    if ((status >= 200 && status < 300) || status == 404 || status == 405) decksReported_ = decks;
+}
+
+std::string FanoutEndpoint::statsJson() const {
+    std::string name;
+    {
+        std::lock_guard<std::mutex> lock(nameMu_);
+        name = name_;
+    }
+    uint64_t sent = sent_.load();
+    std::ostringstream ss;
+    ss << "{"
+       << "\"endpoint\":\"" << name << "\","
+       << "\"up\":" << (up_.load() ? "true" : "false") << ","
+       << "\"published\":" << published_.load() << ","
+       << "\"coalesced\":" << coalesced_.load() << ","
+       << "\"sent\":" << sent << ","
+       << "\"failed\":" << failed_.load() << ","
+       << "\"consecutiveFailures\":" << consecutiveFailures_.load() << ","
+       << "\"lastSendUs\":" << lastSendUs_.load() << ","
+       << "\"maxSendUs\":" << maxSendUs_.load() << ","
+       << "\"avgSendUs\":" << (sent ? totalSendUs_.load() / static_cast<int64_t>(sent) : 0) << ","
+       << "\"link\":" << link_.counters.toJson()
+       << "}";
+    return ss.str();
+}
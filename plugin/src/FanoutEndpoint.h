@@ -0,0 +1,88 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// FanoutEndpoint – an additional server that receives every deck frame
+//
+// Besides the main server link, the plugin can copy its deck state to a
+// few more servers (a backup, a recording box).  Each endpoint has its
+// own HTTP connection, sending thread and newest-frame mailbox, and an
+// optional rate limit.  Frames are encoded once by the poll tick and
+// shared by pointer, so endpoints add no serialization work, and a slow
+// or unreachable endpoint only ever coalesces its own frames.
+//
+// Frames are complete JSON batches (every deck in full), posted to
+// /api/deck/batch: there is no delta state to keep per endpoint.  Like
+// the main sender, each endpoint tells its server the host's deck count
+// (a /api/plugin/stats post with just "decks"), which bounds the decks
+// that server accepts.
+//////////////////////////////////////////////////////////////////////////
+
+#include "LatestSlot.h"
+#include "ServerLink.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class FanoutEndpoint {
+public:
+    using Frame = std::shared_ptr<const std::string>;
+
+    FanoutEndpoint() = default;
+    ~FanoutEndpoint();
+
+    FanoutEndpoint(const FanoutEndpoint&) = delete;
+    FanoutEndpoint& operator=(const FanoutEndpoint&) = delete;
+
+    // Points the endpoint at host:port, sending at most maxHz frames per
+    // second (0 = every frame).  An empty host disables it.  Never blocks.
+    void configure(const std::string& host, const std::string& port, int maxHz);
+    bool enabled() const { return enabled_.load(); }
+
+    void start();
+    void stop();
+
+    // Poll tick: hands over the newest frame, encoded from a host with
+    // `decks` decks.  Never blocks; an unsent frame is replaced.
+    void publish(const Frame& frame, int decks);
+
+    // Health and latency counters, as a JSON object.
+    std::string statsJson() const;
+
+private:
+    static constexpr int kResendRetryMs = 250;  // resend a frame the server did not take
+
+    void run();
+    void reportDecks(int decks);
+
+    ServerLink               link_;
+    LatestSlot<Frame>        slot_;
+    std::thread              thread_;
+    std::atomic<bool>        running_{false};
+    std::atomic<bool>        exited_{true};   // run() returned; stop() stops cancelling
+    std::atomic<bool>        enabled_{false};
+    std::atomic<bool>        up_{false};      // link state, readable from any thread
+    std::atomic<int>         minIntervalMs_{0};
+    std::atomic<int>         decks_{0};       // host deck count of the newest frame
+    uint64_t                 linkEpoch_ = 0;  // sending thread
+    int                      decksReported_ = 0;  // sending thread; 0 = server default
+
+    std::mutex               wakeMu_;
+    std::condition_variable  wakeCv_;
+    bool                     pending_ = false;
+
+    mutable std::mutex       nameMu_;
+    std::string              name_;   // "host:port" for the stats
+
+    std::atomic<uint64_t>    published_{0};
+    std::atomic<uint64_t>    coalesced_{0};  // replaced before it was sent (incl. rate limit)
+    std::atomic<uint64_t>    sent_{0};
+    std::atomic<uint64_t>    failed_{0};
+    std::atomic<uint64_t>    consecutiveFailures_{0};
+    std::atomic<int64_t>     lastSendUs_{0};    // request round trip
+    std::atomic<int64_t>     maxSendUs_{0};
+    std::atomic<int64_t>     totalSendUs_{0};   // over sent_, for the average
+};
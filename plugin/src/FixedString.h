@@ -0,0 +1,69 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// FixedString – inline, bounded, hashed text for DeckState
+//
+// Holds up to N-1 bytes in place with a NUL after them, plus the length
+// and an FNV-1a hash computed once on assign().  The type is trivially
+// copyable, so a DeckState copy (into the outbox, lastState_, the sent
+// state) is one memcpy and never touches the heap, and equality rejects
+// a different string on the hash and length before comparing bytes.
+//
+// Text longer than the capacity is cut at a UTF-8 character boundary,
+// so the JSON and binary encoders never see half a code point.
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+template <size_t N>
+class FixedString {
+    static_assert(N >= 2 && N <= 0xFFFF, "length must fit the u16 of the binary wire format");
+
+public:
+    static constexpr size_t kCapacity = N - 1;  // bytes, without the NUL
+
+    // Bytes past the NUL are left indeterminate: a DeckState is built on
+    // every tick and zeroing the whole buffer would cost more than the copy.
+    FixedString() { data_[0] = '\0'; }
+
+    void assign(const char* s, size_t len) {
+        if (len > kCapacity) {
+            len = kCapacity;
+            while (len > 0 && (static_cast<unsigned char>(s[len]) & 0xC0) == 0x80) --len;
+        }
+        std::memcpy(data_, s, len);
+        data_[len] = '\0';
+        size_ = static_cast<uint16_t>(len);
+        hash_ = fnv1a(data_, len);
+    }
+    void assign(const char* s) { assign(s, std::strlen(s)); }
+    void clear() { assign("", 0); }
+
+    const char* c_str() const { return data_; }
+    const char* data()  const { return data_; }
+    size_t      size()  const { return size_; }
+    bool        empty() const { return size_ == 0; }
+    uint32_t    hash()  const { return hash_; }
+
+    bool operator==(const FixedString& o) const {
+        return hash_ == o.hash_ && size_ == o.size_ && std::memcmp(data_, o.data_, size_) == 0;
+    }
+    bool operator!=(const FixedString& o) const { return !(*this == o); }
+
+private:
+    static constexpr uint32_t kFnvBasis = 2166136261u;
+
+    static uint32_t fnv1a(const char* s, size_t len) {
+        uint32_t h = kFnvBasis;
+        for (size_t i = 0; i < len; ++i) {
+            h ^= static_cast<unsigned char>(s[i]);
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    uint32_t hash_ = kFnvBasis;
+    uint16_t size_ = 0;
+    char     data_[N];
+};
@@ -0,0 +1,51 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// LatestSlot – single-producer / single-consumer "newest value" mailbox
+//
+// A lock-free triple buffer.  The producer writes into its private back
+// buffer and publishes it with one atomic exchange; the consumer takes
+// the newest published buffer with another exchange.  A value that was
+// never consumed is simply replaced (coalesced), so the slot never holds
+// more than one pending value and a slow consumer costs freshness, never
+// producer timing.
+//////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <cstdint>
+
+template <typename T>
+class LatestSlot {
+public:
+    // Producer side. Returns true if an unconsumed value was overwritten.
+    bool publish(const T& value) {
+        buffers_[back_] = value;
+        uint8_t prev = middle_.exchange(static_cast<uint8_t>(back_ | kFresh),
+                                        std::memory_order_acq_rel);
+        back_ = prev & kIndexMask;
+        return (prev & kFresh) != 0;
+    }
+
+    // Consumer side. Returns the newest unconsumed value, or nullptr.
+    // The pointer stays valid until the next take() call.
+    const T* take() {
+        if ((middle_.load(std::memory_order_acquire) & kFresh) == 0) return nullptr;
+        uint8_t prev = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = prev & kIndexMask;
+        taken_ = true;
+        return &buffers_[front_];
+    }
+
+    // Consumer side. The value returned by the last take(), or nullptr
+    // before the first one; lets the consumer resend current state.
+    const T* last() const { return taken_ ? &buffers_[front_] : nullptr; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x03;
+    static constexpr uint8_t kFresh     = 0x04;  // middle holds an unread value
+
+    T                    buffers_[3];
+    uint8_t              back_  = 0;   // owned by the producer
+    uint8_t              front_ = 1;   // owned by the consumer
+    bool                 taken_ = false;  // owned by the consumer
+    std::atomic<uint8_t> middle_{2};   // shared: index | kFresh
+};
@@ -0,0 +1,203 @@
+//////////////////////////////////////////////////////////////////////////
+// NetSocket – implementation
+//////////////////////////////////////////////////////////////////////////
+
+#include "NetSocket.h"
+
+#include <cstring>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace net {
+
+namespace {
+
+// Resolves a numeric address (no DNS) into a sockaddr.
+bool numericAddr(const std::string& address, int port, int socktype,
+                 sockaddr_storage& out, socklen_t& outLen, int& family) {
+    addrinfo hints{};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = socktype;
+    hints.ai_flags    = AI_NUMERICHOST | AI_NUMERICSERV;
+
+    addrinfo* result = nullptr;
+    std::string service = std::to_string(port);
+    if (getaddrinfo(address.c_str(), service.c_str(), &hints, &result) != 0 || !result) return false;
+
+    std::memcpy(&out, result->ai_addr, result->ai_addrlen);
+    outLen = static_cast<socklen_t>(result->ai_addrlen);
+    family = result->ai_family;
+    freeaddrinfo(result);
+    return true;
+}
+
+void setBlocking(socket_t s, bool blocking) {
+#ifdef _WIN32
+    u_long mode = blocking ? 0 : 1;
+    ioctlsocket(s, FIONBIO, &mode);
+#else
+    int flags = fcntl(s, F_GETFL, 0);
+    fcntl(s, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK));
+#endif
+}
+
+void setTimeouts(socket_t s, int timeoutMs) {
+#ifdef _WIN32
+    DWORD tv = static_cast<DWORD>(timeoutMs);
+#else
+    timeval tv{};
+    tv.tv_sec  = timeoutMs / 1000;
+    tv.tv_usec = (timeoutMs % 1000) * 1000;
+#endif
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&tv), sizeof(tv));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&tv), sizeof(tv));
+}
+
+// Waits for readability, or for writability when write is set.  A failed
+// non-blocking connect is reported through the except set on Windows and
+// POLLERR elsewhere, so that counts as "ready" too and the caller checks
+// SO_ERROR.  With a cancel flag the wait runs in kCancelSliceMs slices,
+// checking it between.
+//
+// poll() on POSIX: the host process may hold more than FD_SETSIZE
+// descriptors, and FD_SET() on one past it writes out of bounds.
+// Winsock's fd_set is a list of handles with no such limit, and select()
+// reports a refused connect where WSAPoll() did not before Windows 10
+// 2004, so Windows keeps it.
+bool waitFor(socket_t s, bool write, int timeoutMs, const std::atomic<bool>* cancel) {
+    for (;;) {
+        if (cancel && cancel->load()) return false;
+        int sliceMs = cancel && timeoutMs > kCancelSliceMs ? kCancelSliceMs : timeoutMs;
+#ifdef _WIN32
+        fd_set set, errSet;
+        FD_ZERO(&set);
+        FD_ZERO(&errSet);
+        FD_SET(s, &set);
+        FD_SET(s, &errSet);
+        timeval tv{};
+        tv.tv_sec  = sliceMs / 1000;
+        tv.tv_usec = (sliceMs % 1000) * 1000;
+        int rc = select(0, write ? nullptr : &set, write ? &set : nullptr,
+                        write ? &errSet : nullptr, &tv);
+#else
+        pollfd p{};
+        p.fd     = s;
+        p.events = write ? POLLOUT : POLLIN;
+        int rc = poll(&p, 1, sliceMs);
+#endif
+        if (rc != 0) return rc > 0;
+        timeoutMs -= sliceMs;
+        if (timeoutMs <= 0) return false;
+    }
+}
+
+} // namespace
+
+socket_t connectTcp(const std::string& address, int port, int timeoutMs,
+                    const std::atomic<bool>* cancel) {
+    sockaddr_storage addr{};
+    socklen_t addrLen = 0;
+    int family = 0;
+    if (!numericAddr(address, port, SOCK_STREAM, addr, addrLen, family)) return kInvalidSocket;
+
+    socket_t s = socket(family, SOCK_STREAM, IPPROTO_TCP);
+    if (s == kInvalidSocket) return kInvalidSocket;
+
+#ifdef SO_NOSIGPIPE
+    int one = 1;
+    setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(one));
+#endif
+
+    // Non-blocking connect so a dead host costs timeoutMs, not the OS default.
+    setBlocking(s, false);
+    int rc = connect(s, reinterpret_cast<const sockaddr*>(&addr), addrLen);
+    if (rc != 0) {
+        if (!waitFor(s, true, timeoutMs, cancel)) { closeSocket(s); return kInvalidSocket; }
+        int err = 0;
+        socklen_t len = sizeof(err);
+        getsockopt(s, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&err), &len);
+        if (err != 0) { closeSocket(s); return kInvalidSocket; }
+    }
+    setBlocking(s, true);
+
+    int nodelay = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&nodelay), sizeof(nodelay));
+    setTimeouts(s, timeoutMs);
+    return s;
+}
+
+socket_t connectUdp(const std::string& address, int port) {
+    sockaddr_storage addr{};
+    socklen_t addrLen = 0;
+    int family = 0;
+    if (!numericAddr(address, port, SOCK_DGRAM, addr, addrLen, family)) return kInvalidSocket;
+
+    socket_t s = socket(family, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == kInvalidSocket) return kInvalidSocket;
+
+    // Connecting a UDP socket sends nothing; it only fixes the peer.
+    if (connect(s, reinterpret_cast<const sockaddr*>(&addr), addrLen) != 0) {
+        closeSocket(s);
+        return kInvalidSocket;
+    }
+    return s;
+}
+
+bool sendDatagram(socket_t s, const char* data, size_t len) {
+    auto n = send(s, data, static_cast<int>(len), 0);
+    return n == static_cast<decltype(n)>(len);
+}
+
+bool sendAll(socket_t s, const char* data, size_t len) {
+#ifdef MSG_NOSIGNAL
+    const int flags = MSG_NOSIGNAL;
+#else
+    const int flags = 0;
+#endif
+    while (len > 0) {
+        auto n = send(s, data, static_cast<int>(len), flags);
+        if (n <= 0) return false;
+        data += n;
+        len  -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int recvSome(socket_t s, char* data, size_t len) {
+    auto n = recv(s, data, static_cast<int>(len), 0);
+    return n < 0 ? -1 : static_cast<int>(n);
+}
+
+bool waitReadable(socket_t s, int timeoutMs, const std::atomic<bool>* cancel) {
+    return waitFor(s, false, timeoutMs, cancel);
+}
+
+void shutdownSocket(socket_t s) {
+    if (s == kInvalidSocket) return;
+#ifdef _WIN32
+    shutdown(s, SD_BOTH);
+#else
+    shutdown(s, SHUT_RDWR);
+#endif
+}
+
+void closeSocket(socket_t s) {
+    if (s == kInvalidSocket) return;
+#ifdef _WIN32
+    closesocket(s);
+#else
+    close(s);
+#endif
+}
+
+} // namespace net
@@ -0,0 +1,69 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// NetSocket – thin cross-platform BSD socket helpers
+//
+// Just enough for the raw WebSocket and UDP transports that sit beside
+// cpp-httplib: connect with a timeout, send everything, poll for input.
+// Waits that can last (connect, a handshake reply) take an optional
+// cancel flag and give up within kCancelSliceMs of it being set, so the
+// owning thread can always be joined promptly.
+// Winsock is initialised by httplib.h, which ServerLink.cpp includes.
+// Include only from .cpp files that don't pull in the VDJ SDK headers,
+// so <winsock2.h> is never preceded by a full <windows.h>.
+//////////////////////////////////////////////////////////////////////////
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <sys/types.h>
+#include <sys/socket.h>
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+
+namespace net {
+
+#ifdef _WIN32
+using socket_t = SOCKET;
+constexpr socket_t kInvalidSocket = INVALID_SOCKET;
+#else
+using socket_t = int;
+constexpr socket_t kInvalidSocket = -1;
+#endif
+
+// Longest a cancellable wait goes without checking its cancel flag.
+constexpr int kCancelSliceMs = 5;
+
+// Opens a TCP connection to a numeric address with TCP_NODELAY set and
+// send/receive timeouts of timeoutMs. Returns kInvalidSocket on failure
+// or once *cancel is set.
+socket_t connectTcp(const std::string& address, int port, int timeoutMs,
+                    const std::atomic<bool>* cancel = nullptr);
+
+// Opens a UDP socket connected to a numeric address, so send() needs no
+// destination and ICMP "port unreachable" surfaces as a send error.
+socket_t connectUdp(const std::string& address, int port);
+
+// Sends one datagram. False unless the whole buffer went out.
+bool sendDatagram(socket_t s, const char* data, size_t len);
+
+// Sends the whole buffer. False on error or timeout.
+bool sendAll(socket_t s, const char* data, size_t len);
+
+// Receives up to len bytes. Returns the count, 0 on orderly close, -1 on error.
+int recvSome(socket_t s, char* data, size_t len);
+
+// Waits up to timeoutMs (0 = just check) for s to become readable.
+// False on timeout or once *cancel is set.
+bool waitReadable(socket_t s, int timeoutMs, const std::atomic<bool>* cancel = nullptr);
+
+// Shuts down both directions without closing, so a send or recv blocked
+// on s in another thread returns.  The descriptor stays valid.
+void shutdownSocket(socket_t s);
+
+void closeSocket(socket_t s);
+
+} // namespace net
@@ -0,0 +1,150 @@
+//////////////////////////////////////////////////////////////////////////
+// Scheduler – implementation
+//////////////////////////////////////////////////////////////////////////
+
+#include "Scheduler.h"
+
+#include <sstream>
+
+Scheduler::~Scheduler() {
+    stop();
+}
+
+int Scheduler::add(const char* name, int periodMs, int slackMs, Task run, Align align) {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (count_ >= kMaxTasks) return -1;
+    Entry& t = tasks_[count_];
+    t.name   = name;
+    t.period = std::chrono::milliseconds(periodMs);
+    t.slack  = std::chrono::milliseconds(slackMs);
+    t.run    = std::move(run);
+    t.align  = std::move(align);
+    return count_++;
+}
+
+void Scheduler::start() {
+    std::lock_guard<std::mutex> lock(mu_);
+    if (running_) return;
+    running_ = true;
+    thread_ = std::thread(&Scheduler::loop, this);
+}
+
+void Scheduler::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        running_ = false;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+}
+
+void Scheduler::enable(int id, clock::time_point first) {
+    if (id < 0 || id >= count_) return;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        tasks_[id].enabled  = true;
+        tasks_[id].deadline = first;
+        tasks_[id].armed++;
+    }
+    cv_.notify_all();
+}
+
+void Scheduler::disable(int id) {
+    if (id < 0 || id >= count_) return;
+    std::unique_lock<std::mutex> lock(mu_);
+    tasks_[id].enabled = false;
+    // From a task body the run in progress is the caller's own.
+    if (std::this_thread::get_id() == thread_.get_id()) return;
+    cv_.wait(lock, [&] { return !tasks_[id].running; });
+}
+
+void Scheduler::setPeriod(int id, int periodMs) {
+    if (id < 0 || id >= count_) return;
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        Entry& t = tasks_[id];
+        t.period = std::chrono::milliseconds(periodMs);
+        if (t.running || !t.enabled) return;
+        auto next = clock::now() + t.period;
+        if (next >= t.deadline) return;
+        t.deadline = next;
+    }
+    cv_.notify_all();
+}
+
+void Scheduler::loop() {
+    std::unique_lock<std::mutex> lock(mu_);
+    while (running_) {
+        // Run whatever is due, most urgent first; otherwise sleep until
+        // the first deadline that cannot slip any further.
+        auto now = clock::now();
+        Entry* next = nullptr;
+        for (int i = 0; i < count_; ++i) {
+            Entry& t = tasks_[i];
+            if (t.enabled && (!next || t.deadline + t.slack < next->deadline + next->slack)) next = &t;
+        }
+        if (!next) {
+            cv_.wait(lock);
+            continue;
+        }
+        if (now < next->deadline) {
+            // Nothing is due yet.  enable()/stop() wake us early and the
+            // table is simply re-scanned.
+            cv_.wait_until(lock, next->deadline + next->slack);
+            wakeups_++;
+            continue;
+        }
+
+        Entry& t = *next;
+        int64_t lateUs = std::chrono::duration_cast<std::chrono::microseconds>(now - t.deadline).count();
+        int bucket = 0;
+        while (bucket < kBuckets && lateUs > kBucketUs[bucket]) ++bucket;
+        t.lateness[bucket]++;
+        if (lateUs > t.maxLateUs.load()) t.maxLateUs = lateUs;
+        t.runs++;
+
+        t.running = true;
+        uint32_t armed = t.armed;
+        lock.unlock();
+        t.run();
+        lock.lock();
+        t.running = false;
+        cv_.notify_all();
+
+        // Next deadline from the previous one, not from now: wakeup
+        // latency does not accumulate.  Ticks already missed are dropped.
+        auto deadline = t.deadline + t.period;
+        now = clock::now();
+        if (deadline <= now) {
+            auto missed = (now - deadline) / t.period + 1;
+            deadline += missed * t.period;
+            t.skipped += static_cast<uint64_t>(missed);
+        }
+        if (t.align) deadline = t.align(deadline);
+        // enable() while the task ran set a fresh deadline; keep it.
+        if (t.armed == armed) t.deadline = deadline;
+    }
+}
+
+std::string Scheduler::statsJson() const {
+    std::ostringstream ss;
+    ss << "{\"wakeups\":" << wakeups_.load();
+    for (int i = 0; i < count_; ++i) {
+        const Entry& t = tasks_[i];
+        ss << ",\"" << t.name << "\":{"
+           << "\"runs\":" << t.runs.load() << ","
+           << "\"skipped\":" << t.skipped.load() << ","
+           << "\"maxLateUs\":" << t.maxLateUs.load() << ","
+           << "\"lateUs\":{";
+        for (int b = 0; b <= kBuckets; ++b) {
+            if (b > 0) ss << ',';
+            ss << '"';
+            if (b < kBuckets) ss << "le" << kBucketUs[b];
+            else              ss << "gt" << kBucketUs[kBuckets - 1];
+            ss << "\":" << t.lateness[b].load();
+        }
+        ss << "}}";
+    }
+    ss << "}";
+    return ss.str();
+}
@@ -0,0 +1,96 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// Scheduler – one thread running the plugin's periodic tasks
+//
+// Deck polling, the settings watch and the stats heartbeat each used to
+// own a sleep loop.  Here they are entries in a small fixed task table
+// served by a single thread that sleeps until the earliest absolute
+// deadline.  A task's next deadline is its previous one plus its period
+// (never "now + period"), so late wakeups do not accumulate into drift;
+// a task that falls more than a period behind skips the missed ticks
+// instead of bursting.  Periods may change at run time (the poll adapts
+// its rate to deck activity).  An optional align hook lets a task move its
+// next deadline, e.g. onto an audio block boundary.  A task with slack
+// may run up to that much after its deadline, so it rides along with
+// another task's wakeup instead of causing its own.
+//
+// Every run records how late it started against its deadline in a
+// per-task histogram, which bounds the poll jitter observably.
+//
+// add() is called before start(); the other methods from any thread.
+// Task bodies run on the scheduler thread, one at a time.
+//////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+class Scheduler {
+public:
+    using clock = std::chrono::steady_clock;
+    using Task  = std::function<void()>;
+    using Align = std::function<clock::time_point(clock::time_point)>;
+
+    Scheduler() = default;
+    ~Scheduler();
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    // Registers a task, disabled.  Returns its id, or -1 if the table is
+    // full.  name must outlive the scheduler (a string literal).
+    int add(const char* name, int periodMs, int slackMs, Task run, Align align = nullptr);
+
+    void start();
+    void stop();
+
+    // Enables a task with its first run at first, or disables it.
+    // Disabling waits for a run in progress to finish, so the task's
+    // state may be torn down right after.
+    void enable(int id, clock::time_point first = clock::now());
+    void disable(int id);
+    // Changes a task's period.  From its own body the next deadline uses
+    // it; otherwise a shorter period also pulls the pending deadline in.
+    void setPeriod(int id, int periodMs);
+
+    // Per-task run counts and lateness histograms, as a JSON object.
+    std::string statsJson() const;
+
+    static constexpr int kMaxTasks = 4;
+    // Upper bounds (µs) of the lateness buckets; one more for the rest.
+    static constexpr int kBuckets = 7;
+    static constexpr int64_t kBucketUs[kBuckets] = {100, 250, 500, 1000, 2000, 5000, 10000};
+
+private:
+    struct Entry {
+        const char*       name = nullptr;
+        clock::duration   period{};
+        clock::duration   slack{};
+        Task              run;
+        Align             align;
+        bool              enabled = false;
+        bool              running = false;
+        clock::time_point deadline{};
+        uint32_t          armed = 0;      // bumped by enable()
+
+        std::atomic<uint64_t> runs{0};
+        std::atomic<uint64_t> skipped{0};     // ticks dropped after falling behind
+        std::atomic<int64_t>  maxLateUs{0};
+        std::atomic<uint64_t> lateness[kBuckets + 1] = {};
+    };
+
+    void loop();
+
+    Entry                   tasks_[kMaxTasks];
+    int                     count_ = 0;
+    std::thread             thread_;
+    bool                    running_ = false;   // guarded by mu_
+    mutable std::mutex      mu_;
+    std::condition_variable cv_;
+    std::atomic<uint64_t>   wakeups_{0};
+};
@@ -0,0 +1,376 @@
+//////////////////////////////////////////////////////////////////////////
+// ServerLink – implementation
+//////////////////////////////////////////////////////////////////////////
+
+#define CPPHTTPLIB_NO_EXCEPTIONS
+#include "ServerLink.h"
+#include "WsClient.h"
+#include "UdpClient.h"
+#include "ShmRing.h"
+#include "httplib.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#endif
+
+std::string LinkCounters::toJson() const {
+    std::ostringstream ss;
+    ss << "{"
+       << "\"connects\":" << connects.load() << ","
+       << "\"reconnects\":" << reconnects.load() << ","
+       << "\"connectFailures\":" << connectFailures.load() << ","
+       << "\"coldSends\":" << coldSends.load() << ","
+       << "\"lastConnectUs\":" << lastConnectUs.load() << ","
+       << "\"maxConnectUs\":" << maxConnectUs.load() << ","
+       << "\"wsConnects\":" << wsConnects.load() << ","
+       << "\"wsFailures\":" << wsFailures.load() << ","
+       << "\"wsFrames\":" << wsFrames.load() << ","
+       << "\"controlMessages\":" << controlMessages.load() << ","
+       << "\"udpDatagrams\":" << udpDatagrams.load() << ","
+       << "\"udpErrors\":" << udpErrors.load() << ","
+       << "\"shmRecords\":" << shmRecords.load() << ","
+       << "\"shmErrors\":" << shmErrors.load() << ","
+       << "\"breakerTrips\":" << breakerTrips.load() << ","
+       << "\"backoffMs\":" << backoffMs.load() << ","
+       << "\"srttUs\":" << srttUs.load() << ","
+       << "\"timeoutMs\":" << timeoutMs.load()
+       << "}";
+    return ss.str();
+}
+
+bool parseTransport(const char* s, Transport& out) {
+    if (!s) return false;
+    if (std::strcmp(s, "http") == 0) { out = Transport::Http;      return true; }
+    if (std::strcmp(s, "ws") == 0)   { out = Transport::WebSocket; return true; }
+    if (std::strcmp(s, "udp") == 0)  { out = Transport::Udp;       return true; }
+    if (std::strcmp(s, "shm") == 0)  { out = Transport::Shm;       return true; }
+    return false;
+}
+
+ServerLink::ServerLink()
+    : ws_(std::make_unique<WsClient>()), udp_(std::make_unique<UdpClient>()),
+      shm_(std::make_unique<ShmRing>()) {}
+ServerLink::~ServerLink() = default;
+
+void ServerLink::setEndpoint(const std::string& host, const std::string& port, Transport transport) {
+    std::lock_guard<std::mutex> lock(endpointMu_);
+    pendingHost_      = host;
+    pendingPort_      = port;
+    pendingTransport_ = transport;
+    endpointChanged_  = true;
+}
+
+bool ServerLink::ensureConnected() {
+    {
+        std::lock_guard<std::mutex> lock(endpointMu_);
+        if (endpointChanged_) {
+            host_    = pendingHost_;
+            port_    = std::atoi(pendingPort_.c_str());
+            transport_ = pendingTransport_;
+            endpointChanged_ = false;
+            address_.clear();
+            resetClient();
+            ws_->close();
+            udp_->close();
+            shm_->close();
+            streamRetryAt_ = clock::time_point{};
+            up_      = false;
+            everUp_  = false;
+            nextAttempt_ = clock::time_point{};
+            batchSupported = true;  // re-probe: the new server may support batching
+            binarySupported = false;
+            failures_  = 0;
+            backoffMs_ = 0;
+            haveRtt_   = false;
+            timeoutMs_ = kMaxTimeoutMs;
+        }
+    }
+
+    if (cancelled_.load()) return false;
+    if (up_) {
+        openStream();
+        return true;
+    }
+    if (clock::now() < nextAttempt_) return false;
+    if (connect()) {
+        openStream();
+        return true;
+    }
+
+    counters.connectFailures++;
+    scheduleProbe();
+    return false;
+}
+
+// Opens the breaker until the next probe: the backoff doubles per failed
+// probe, and the delay is drawn from [backoff/2, backoff] so plugins
+// that lost the same server don't probe it in lockstep.  The timeout
+// doubles too, in case the server is alive but slower than measured.
+void ServerLink::scheduleProbe() {
+    backoffMs_ = backoffMs_ == 0 ? kBackoffMinMs : std::min(backoffMs_ * 2, kBackoffMaxMs);
+    timeoutMs_ = std::min(timeoutMs_ * 2, kMaxTimeoutMs);
+    applyTimeout();
+    int delay = backoffMs_ / 2 + static_cast<int>(jitter_() % static_cast<unsigned>(backoffMs_ / 2 + 1));
+    nextAttempt_ = clock::now() + std::chrono::milliseconds(delay);
+    counters.backoffMs = backoffMs_;
+}
+
+// Folds one request round trip into the smoothed RTT and derives the
+// timeout from it: srtt + 4 * rttvar, clamped (RFC 6298).
+void ServerLink::sampleRtt(int64_t us) {
+    double ms = us / 1000.0;
+    if (!haveRtt_) {
+        srttMs_   = ms;
+        rttvarMs_ = ms / 2.0;
+        haveRtt_  = true;
+    } else {
+        rttvarMs_ = 0.75 * rttvarMs_ + 0.25 * std::fabs(srttMs_ - ms);
+        srttMs_   = 0.875 * srttMs_ + 0.125 * ms;
+    }
+    int timeout = static_cast<int>(std::ceil(srttMs_ + 4.0 * rttvarMs_));
+    timeout = std::max(kMinTimeoutMs, std::min(timeout, kMaxTimeoutMs));
+    counters.srttUs = static_cast<int64_t>(srttMs_ * 1000.0);
+    if (timeout != timeoutMs_) {
+        timeoutMs_ = timeout;
+        applyTimeout();
+    }
+}
+
+void ServerLink::applyTimeout() {
+    counters.timeoutMs = timeoutMs_;
+    if (client_) setClientTimeout(timeoutMs_);
+}
+
+void ServerLink::setClientTimeout(int ms) {
+    auto timeout = std::chrono::milliseconds(ms);
+    client_->set_connection_timeout(timeout);
+    client_->set_read_timeout(timeout);
+    client_->set_write_timeout(timeout);
+}
+
+bool ServerLink::connect() {
+    if (host_.empty() || port_ <= 0) return false;
+
+    auto start = clock::now();
+
+    // Resolve once per endpoint; reconnects reuse the cached address.
+    if (address_.empty()) {
+        address_ = resolve(host_, std::to_string(port_));
+        if (address_.empty()) return false;
+        resetClient();
+    }
+
+    if (!client_) {
+        auto client = std::make_unique<httplib::Client>(host_, port_);
+        client->set_hostname_addr_map({{host_, address_}});
+        client->set_keep_alive(true);
+        client->set_tcp_nodelay(true);
+        std::lock_guard<std::mutex> lock(clientMu_);
+        client_ = std::move(client);
+        applyTimeout();
+    }
+
+    // Prewarm: any HTTP response (even 404 from an older server) proves
+    // the keep-alive socket is open.
+    auto result = client_->Get("/api/ping");
+    if (!result || cancelled_.load()) return false;
+    binarySupported = result->get_header_value("Accept-Post").find(kDeckBinaryType)
+                      != std::string::npos;
+
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+    sampleRtt(us);
+    counters.lastConnectUs = us;
+    if (us > counters.maxConnectUs.load()) counters.maxConnectUs = us;
+    if (everUp_) counters.reconnects++;
+    counters.connects++;
+    everUp_ = true;
+    up_     = true;
+    failures_  = 0;
+    backoffMs_ = 0;
+    counters.backoffMs = 0;
+    epoch_++;
+    return true;
+}
+
+void ServerLink::resetClient() {
+    std::lock_guard<std::mutex> lock(clientMu_);
+    client_.reset();
+}
+
+void ServerLink::cancel() {
+    cancelled_ = true;
+    ws_->cancel();
+    std::lock_guard<std::mutex> lock(clientMu_);
+    if (client_) client_->stop();
+}
+
+void ServerLink::resume() {
+    cancelled_ = false;
+    ws_->resume();
+}
+
+// Returns the numeric address for host, preferring IPv4 so names like
+// "localhost" don't pay a failed ::1 attempt first. Empty on failure.
+std::string ServerLink::resolve(const std::string& host, const std::string& port) {
+    addrinfo hints{};
+    hints.ai_family   = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || !result) return {};
+
+    const addrinfo* pick = result;
+    for (const addrinfo* ai = result; ai; ai = ai->ai_next) {
+        if (ai->ai_family == AF_INET) { pick = ai; break; }
+    }
+
+    char buf[NI_MAXHOST] = {};
+    int rc = getnameinfo(pick->ai_addr, static_cast<socklen_t>(pick->ai_addrlen),
+                         buf, sizeof(buf), nullptr, 0, NI_NUMERICHOST);
+    freeaddrinfo(result);
+    return rc == 0 ? std::string(buf) : std::string();
+}
+
+// Opens the WebSocket stream, UDP socket or shared-memory ring if one
+// is selected and due for an attempt. Failure is not fatal: frames go
+// over HTTP until the next attempt.
+void ServerLink::openStream() {
+    if (transport_ == Transport::Udp) {
+        // A UDP "connect" only needs the resolved address, so it can
+        // fail only on local socket errors.
+        if (!udp_->isOpen()) udp_->open(address_, port_);
+        return;
+    }
+    if (transport_ == Transport::Shm) {
+        if (shm_->isOpen() || clock::now() < streamRetryAt_) return;
+        if (!shm_->open(ShmRing::defaultPath())) {
+            counters.shmErrors++;
+            streamRetryAt_ = clock::now() + std::chrono::milliseconds(kStreamRetryMs);
+        }
+        return;
+    }
+    if (transport_ != Transport::WebSocket || ws_->isOpen()) return;
+    if (clock::now() < streamRetryAt_) return;
+
+    std::string hostHeader = host_ + ":" + std::to_string(port_);
+    if (ws_->open(address_, port_, hostHeader, "/api/deck/ws", timeoutMs_)) {
+        counters.wsConnects++;
+        epoch_++;
+    } else {
+        counters.wsFailures++;
+        streamRetryAt_ = clock::now() + std::chrono::milliseconds(kStreamRetryMs);
+    }
+}
+
+bool ServerLink::streamOpen() const {
+    return ws_->isOpen();
+}
+
+bool ServerLink::stream(const std::string& frame, bool binary) {
+    if (!(binary ? ws_->sendBinary(frame) : ws_->sendText(frame))) {
+        // Dropped stream: fall back to HTTP now and retry the upgrade on
+        // the next ensureConnected().
+        counters.wsFailures++;
+        return false;
+    }
+    counters.wsFrames++;
+    return true;
+}
+
+bool ServerLink::datagramOpen() const {
+    return udp_->isOpen() || shm_->isOpen();
+}
+
+bool ServerLink::sendDatagram(const std::string& frame) {
+    if (shm_->isOpen()) {
+        // Fails while no server is reading the ring (or the frame is
+        // larger than a slot); that frame goes over HTTP instead.
+        if (!shm_->write(frame)) {
+            counters.shmErrors++;
+            return false;
+        }
+        counters.shmRecords++;
+        return true;
+    }
+    if (!udp_->send(frame)) {
+        // Usually the ICMP port-unreachable of an earlier datagram: the
+        // server has no UDP listener. Keep trying; each failure costs
+        // one HTTP fallback for that frame only.
+        counters.udpErrors++;
+        return false;
+    }
+    counters.udpDatagrams++;
+    return true;
+}
+
+void ServerLink::pollControl() {
+    if (!ws_->isOpen()) return;
+    bool ok = ws_->poll([this](const std::string& msg) {
+        counters.controlMessages++;
+        if (onControl) onControl(msg);
+    });
+    if (!ok) counters.wsFailures++;
+}
+
+void ServerLink::heartbeat() {
+    if (ws_->isOpen() && !ws_->ping()) counters.wsFailures++;
+}
+
+int ServerLink::post(const char* path, const std::string& body, const char* contentType,
+                     std::string* response, RequestKind kind) {
+    if (!up_ || !client_ || cancelled_.load()) return -1;
+
+    if (!client_->is_socket_open()) counters.coldSends++;
+    if (kind == RequestKind::Background) setClientTimeout(kMaxTimeoutMs);
+    auto start = clock::now();
+    auto result = client_->Post(path, body, contentType);
+    if (kind == RequestKind::Background) setClientTimeout(timeoutMs_);
+    if (cancelled_.load()) return -1;  // aborted by cancel(): not the server's fault
+    if (!recordResult(static_cast<bool>(result), start, kind)) return -1;
+    if (response) *response = result->body;
+    return result->status;
+}
+
+int ServerLink::get(const char* path, std::string* response, RequestKind kind) {
+    if (!up_ || !client_ || cancelled_.load()) return -1;
+
+    if (!client_->is_socket_open()) counters.coldSends++;
+    if (kind == RequestKind::Background) setClientTimeout(kMaxTimeoutMs);
+    auto start = clock::now();
+    auto result = client_->Get(path);
+    if (kind == RequestKind::Background) setClientTimeout(timeoutMs_);
+    if (cancelled_.load()) return -1;  // aborted by cancel(): not the server's fault
+    if (!recordResult(static_cast<bool>(result), start, kind)) return -1;
+    if (response) *response = result->body;
+    return result->status;
+}
+
+// Books the outcome of a deck request started at start: an RTT sample
+// on success, otherwise one step towards opening the breaker.
+bool ServerLink::recordResult(bool ok, clock::time_point start, RequestKind kind) {
+    if (kind == RequestKind::Background) return ok;
+    if (!ok) {
+        // httplib reopens the socket on the next request; only a run of
+        // errors opens the breaker and hands over to background probes.
+        if (++failures_ >= kBreakerThreshold) {
+            up_ = false;
+            counters.breakerTrips++;
+            scheduleProbe();
+        }
+        return false;
+    }
+    failures_ = 0;
+    sampleRtt(std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count());
+    return true;
+}
@@ -0,0 +1,205 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// ServerLink – long-lived HTTP connection to the video sync server
+//
+// Owns one keep-alive httplib::Client with Nagle disabled.  The server
+// address is resolved once per endpoint change (IPv4 preferred, so
+// "localhost" does not try ::1 first) and pinned in the client, and the
+// connection is prewarmed with GET /api/ping so steady-state sends never
+// pay DNS or TCP setup.
+//
+// With the WebSocket transport selected, deck frames are streamed over
+// /api/deck/ws without waiting for replies, and the server can push
+// control messages back.  HTTP stays up alongside it for stats and as
+// the fallback whenever the stream is down.
+//
+// With the UDP transport selected, complete deck frames are sent as
+// single datagrams to the same port.  Nothing is acknowledged, so there
+// is no head-of-line blocking; HTTP again carries stats and takes over
+// any frame a datagram could not send.
+//
+// With the shared-memory transport selected, the same frames are written
+// into a memory-mapped ring file (see ShmRing.h) that a server on the
+// same machine reads, with no socket on the path.  The configured
+// address is still used for HTTP stats and fallback.
+//
+// Failures go through a circuit breaker: a few consecutive transport
+// errors open it, sends then fail fast, and the server is probed in the
+// background with exponential backoff and jitter.  Deck request timeouts
+// follow the measured round-trip time (RFC 6298 style) instead of a
+// fixed two seconds, so a dead server is detected in a few RTTs.  The
+// slower stats and subscription requests keep the two seconds and stay
+// out of the estimate and the breaker (RequestKind).
+//
+// setEndpoint() and cancel() may be called from any thread.  Everything
+// else runs on the single sending thread that owns the link.
+//////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+
+// Forward-declare to avoid pulling httplib.h / socket headers into the header
+namespace httplib { class Client; }
+class WsClient;
+class UdpClient;
+class ShmRing;
+
+// ── Deck-frame transport, chosen from the plugin parameters ──
+enum class Transport { Http, WebSocket, Udp, Shm };
+
+// Parses "http" / "ws" / "udp" / "shm". Returns false for anything else.
+bool parseTransport(const char* s, Transport& out);
+
+// Which requests the RTT estimate and the breaker follow.  Deck frames
+// and the clock exchange hit cheap handlers on the latency-critical
+// path.  Background requests (stats, subscriptions, overlay verbs) may
+// keep their handlers busy for longer: they always get kMaxTimeoutMs,
+// and neither their round trip nor their failure is booked.
+enum class RequestKind { Deck, Background };
+
+// Content type of the binary deck frame (see DeckState::appendBinary).
+// Servers that accept it list it in the Accept-Post header of /api/ping.
+constexpr char kDeckBinaryType[] = "application/x-vdj-deck";
+
+// ── Connection counters (reported with the sender stats) ──
+struct LinkCounters {
+    std::atomic<uint64_t> connects{0};         // successful prewarmed connects
+    std::atomic<uint64_t> reconnects{0};       // connects after a working link failed
+    std::atomic<uint64_t> connectFailures{0};  // failed resolve / prewarm attempts
+    std::atomic<uint64_t> coldSends{0};        // posts that had to open a new socket
+    std::atomic<int64_t>  lastConnectUs{0};    // duration of the last prewarm
+    std::atomic<int64_t>  maxConnectUs{0};
+    std::atomic<uint64_t> wsConnects{0};       // WebSocket upgrades completed
+    std::atomic<uint64_t> wsFailures{0};       // upgrades refused or streams dropped
+    std::atomic<uint64_t> wsFrames{0};         // deck frames streamed
+    std::atomic<uint64_t> controlMessages{0};  // messages pushed by the server
+    std::atomic<uint64_t> udpDatagrams{0};     // deck frames sent as datagrams
+    std::atomic<uint64_t> udpErrors{0};        // datagrams that failed to send
+    std::atomic<uint64_t> shmRecords{0};       // deck frames written to the ring
+    std::atomic<uint64_t> shmErrors{0};        // ring open failures and unread writes
+    std::atomic<uint64_t> breakerTrips{0};     // times consecutive failures took the link down
+    std::atomic<int64_t>  backoffMs{0};        // current probe backoff (0 while up)
+    std::atomic<int64_t>  srttUs{0};           // smoothed request round-trip time
+    std::atomic<int64_t>  timeoutMs{0};        // current request timeout
+
+    std::string toJson() const;
+};
+
+class ServerLink {
+public:
+    using clock = std::chrono::steady_clock;
+
+    ServerLink();
+    ~ServerLink();
+
+    // Point the link at a new server. Resolution and the reconnect happen
+    // lazily on the sending thread.
+    void setEndpoint(const std::string& host, const std::string& port, Transport transport);
+
+    // Resolves (once per endpoint) and prewarms the connection if it is
+    // down. Returns false while the server is unreachable (breaker open);
+    // the next probe is not made before retryAt().
+    bool ensureConnected();
+    bool isUp() const { return up_; }
+
+    // Aborts a request or stream handshake in progress and fails every
+    // later one (-1, no breaker step) until resume(), so the sending
+    // thread can be joined promptly.  Only an HTTP connect already under
+    // way runs to its connection timeout (httplib holds its socket lock
+    // through it).
+    void cancel();
+    void resume();
+
+    // Bumped on every new HTTP connection or stream. A change means frames
+    // may have been lost in between, or the server may have restarted.
+    uint64_t epoch() const { return epoch_; }
+    clock::time_point retryAt() const { return nextAttempt_; }
+
+    // POSTs body to path. Returns the HTTP status, or -1 on a transport
+    // error or while the breaker is open. kBreakerThreshold consecutive
+    // errors of deck requests mark the link down for a background probe.
+    // The response body is stored in *response when one is given.
+    int post(const char* path, const std::string& body, const char* contentType,
+             std::string* response = nullptr, RequestKind kind = RequestKind::Deck);
+
+    // GETs path, with the same status and breaker semantics as post().
+    int get(const char* path, std::string* response = nullptr,
+            RequestKind kind = RequestKind::Deck);
+
+    // WebSocket stream: send one frame without waiting for a reply.
+    // False if the stream is down; the caller falls back to post().
+    bool streamOpen() const;
+    bool stream(const std::string& frame, bool binary);
+
+    // UDP / shared memory: send one complete frame as a single datagram
+    // or ring record. False if neither is selected or the send failed;
+    // use post() instead.
+    bool datagramOpen() const;
+    bool sendDatagram(const std::string& frame);
+
+    // Delivers pushed server messages to onControl (non-blocking) and
+    // keeps an idle stream alive. Called by the sending thread.
+    void pollControl();
+    void heartbeat();
+    std::function<void(const std::string&)> onControl;
+
+    // Capabilities of the server at the other end; reset on endpoint change.
+    bool batchSupported = true;
+    bool binarySupported = false;  // learned from the prewarm response
+
+    LinkCounters counters;
+
+private:
+    bool connect();
+    static std::string resolve(const std::string& host, const std::string& port);
+
+    void openStream();
+    bool recordResult(bool ok, clock::time_point start, RequestKind kind);
+    void scheduleProbe();
+    void sampleRtt(int64_t us);
+    void applyTimeout();
+    void setClientTimeout(int ms);
+    void resetClient();
+
+    static constexpr int kBreakerThreshold = 3;      // consecutive transport errors
+    static constexpr int kBackoffMinMs     = 250;
+    static constexpr int kBackoffMaxMs     = 10000;
+    static constexpr int kMinTimeoutMs     = 250;
+    static constexpr int kMaxTimeoutMs     = 2000;   // also used until an RTT is measured
+    static constexpr int kStreamRetryMs = 5000;  // also paces probes of servers without /api/deck/ws
+
+    std::mutex  endpointMu_;
+    std::string pendingHost_;
+    std::string pendingPort_;
+    Transport   pendingTransport_ = Transport::Http;
+    bool        endpointChanged_ = false;
+
+    std::string host_;
+    int         port_ = 0;
+    Transport   transport_ = Transport::Http;
+    std::string address_;   // cached numeric address for host_
+    bool        up_ = false;
+    bool        everUp_ = false;
+    uint64_t    epoch_ = 0;
+    clock::time_point nextAttempt_{};
+    int         failures_ = 0;          // consecutive post() transport errors
+    int         backoffMs_ = 0;         // 0 = next failure starts at kBackoffMinMs
+    bool        haveRtt_ = false;
+    double      srttMs_ = 0.0;
+    double      rttvarMs_ = 0.0;
+    int         timeoutMs_ = kMaxTimeoutMs;
+    std::minstd_rand jitter_{std::random_device{}()};
+    std::atomic<bool>                cancelled_{false};
+    std::mutex                       clientMu_;  // client_ replacement vs cancel()
+    std::unique_ptr<httplib::Client> client_;
+    std::unique_ptr<WsClient>        ws_;
+    std::unique_ptr<UdpClient>       udp_;
+    std::unique_ptr<ShmRing>         shm_;
+    clock::time_point                streamRetryAt_{};
+};
@@ -0,0 +1,168 @@
+//////////////////////////////////////////////////////////////////////////
+// ShmRing – implementation
+//////////////////////////////////////////////////////////////////////////
+
+#include "ShmRing.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+// The reader is another process: the shared words must be plain 8-byte
+// lock-free atomics with no hidden state.
+static_assert(sizeof(std::atomic<uint64_t>) == 8 && std::atomic<uint64_t>::is_always_lock_free,
+              "ring words must be lock-free 64-bit atomics");
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "the ring layout assumes a little-endian host"
+#endif
+
+namespace {
+
+// Header offsets
+constexpr size_t kOffMagic       = 0;
+constexpr size_t kOffVersion     = 4;
+constexpr size_t kOffSlotCount   = 8;
+constexpr size_t kOffSlotSize    = 12;
+constexpr size_t kOffWriteIndex  = 16;
+constexpr size_t kOffReaderPulse = 24;
+
+std::atomic<uint64_t>& word(unsigned char* p) {
+    return *reinterpret_cast<std::atomic<uint64_t>*>(p);
+}
+
+uint32_t getU32(const unsigned char* p) {
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+void putU32(unsigned char* p, uint32_t v) {
+    std::memcpy(p, &v, 4);
+}
+
+} // namespace
+
+ShmRing::~ShmRing() {
+    close();
+}
+
+bool ShmRing::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE,
+                              FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    file_ = file;
+    // Mapping with an explicit size grows the file to fit.
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                        0, static_cast<DWORD>(kFileSize), nullptr);
+    if (!mapping) { close(); return false; }
+    mapping_ = mapping;
+    base_ = static_cast<unsigned char*>(MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, kFileSize));
+    if (!base_) { close(); return false; }
+#else
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd_ < 0) return false;
+    struct stat st{};
+    if (fstat(fd_, &st) != 0
+        || (st.st_size != static_cast<off_t>(kFileSize)
+            && ftruncate(fd_, static_cast<off_t>(kFileSize)) != 0)) {
+        close();
+        return false;
+    }
+    void* p = mmap(nullptr, kFileSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) { close(); return false; }
+    base_ = static_cast<unsigned char*>(p);
+#endif
+
+    if (getU32(base_ + kOffMagic) == kMagic && getU32(base_ + kOffVersion) == kVersion
+        && getU32(base_ + kOffSlotCount) == kSlotCount && getU32(base_ + kOffSlotSize) == kSlotSize) {
+        next_ = word(base_ + kOffWriteIndex).load(std::memory_order_acquire);
+        return true;
+    }
+
+    // New or foreign file: clear the indices and slot seqlocks before
+    // stamping the magic, which readers check first.
+    putU32(base_ + kOffMagic, 0);
+    std::atomic_thread_fence(std::memory_order_release);
+    word(base_ + kOffWriteIndex).store(0, std::memory_order_relaxed);
+    for (uint32_t i = 0; i < kSlotCount; ++i) {
+        word(base_ + kHeaderSize + size_t{i} * kSlotSize).store(0, std::memory_order_relaxed);
+    }
+    putU32(base_ + kOffVersion, kVersion);
+    putU32(base_ + kOffSlotCount, kSlotCount);
+    putU32(base_ + kOffSlotSize, kSlotSize);
+    std::atomic_thread_fence(std::memory_order_release);
+    putU32(base_ + kOffMagic, kMagic);
+    next_ = 0;
+    return true;
+}
+
+void ShmRing::close() {
+#ifdef _WIN32
+    if (base_) UnmapViewOfFile(base_);
+    if (mapping_) CloseHandle(static_cast<HANDLE>(mapping_));
+    if (file_) CloseHandle(static_cast<HANDLE>(file_));
+    mapping_ = nullptr;
+    file_    = nullptr;
+#else
+    if (base_) munmap(base_, kFileSize);
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = -1;
+#endif
+    base_ = nullptr;
+}
+
+bool ShmRing::write(const std::string& frame) {
+    if (!base_ || frame.size() > kSlotSize - kSlotHeaderSize) return false;
+
+    // Without a live reader the frames would vanish; report failure so
+    // the caller sends them over HTTP instead.
+    int64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    int64_t pulse = static_cast<int64_t>(
+        word(base_ + kOffReaderPulse).load(std::memory_order_relaxed));
+    if (nowMs - pulse > kReaderTimeoutMs) return false;
+
+    unsigned char* slot = base_ + kHeaderSize + (next_ % kSlotCount) * size_t{kSlotSize};
+    std::atomic<uint64_t>& seq = word(slot);
+
+    // Seqlock write: odd while the payload is in flux, even once complete.
+    seq.store(2 * next_ + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    putU32(slot + 8, static_cast<uint32_t>(frame.size()));
+    std::memcpy(slot + kSlotHeaderSize, frame.data(), frame.size());
+    seq.store(2 * next_ + 2, std::memory_order_release);
+
+    ++next_;
+    word(base_ + kOffWriteIndex).store(next_, std::memory_order_release);
+    return true;
+}
+
+std::string ShmRing::defaultPath() {
+#ifdef _WIN32
+    char dir[MAX_PATH + 1] = {};
+    DWORD n = GetTempPathA(sizeof(dir), dir);
+    std::string path = (n > 0 && n < sizeof(dir)) ? std::string(dir, n) : std::string(".\\");
+#else
+    const char* env = std::getenv("TMPDIR");
+    std::string path = (env && *env) ? env : "/tmp";
+    if (path.back() != '/') path += '/';
+#endif
+    return path + "vdj-video-sync.ring";
+}
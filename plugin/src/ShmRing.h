@@ -0,0 +1,75 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// ShmRing – memory-mapped ring of deck frames for a co-located server
+//
+// The plugin writes complete deck frames into a file mapped into both
+// processes; the server maps the same file and reads them.  Each slot is
+// guarded by its own seqlock, so the write path is a memcpy and three
+// stores: no locks, no syscalls, and a slow reader never blocks it.
+//
+// File layout (little-endian, all offsets 8-byte aligned):
+//
+//   header (64 bytes)
+//     u32 magic           'VDJR'
+//     u32 version         kVersion
+//     u32 slotCount
+//     u32 slotSize        bytes per slot, slot header included
+//     u64 writeIndex      records published so far (written last)
+//     u64 readerPulseMs   reader's wall clock (ms since epoch), refreshed
+//                         while a server is reading
+//     reserved up to 64 bytes
+//   slotCount slots of slotSize bytes, record n in slot n % slotCount
+//     u64 seq             2n+1 while record n is written, 2n+2 once done
+//     u32 length          payload bytes
+//     u32 reserved
+//     payload             one deck frame (binary wire format)
+//
+// Not thread-safe: owned by the sending thread (through ServerLink).
+//////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class ShmRing {
+public:
+    ShmRing() = default;
+    ~ShmRing();
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    // Creates or reuses the ring file at path and maps it.  A ring with
+    // the same geometry keeps its writeIndex so a running reader never
+    // sees it move backwards.
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return base_ != nullptr; }
+
+    // Publishes one frame.  False if it does not fit in a slot or no
+    // reader has refreshed its pulse within kReaderTimeoutMs.
+    bool write(const std::string& frame);
+
+    // Default ring file: vdj-video-sync.ring in the user's temp directory
+    // (the server's default -shm path).
+    static std::string defaultPath();
+
+    static constexpr uint32_t kMagic     = 0x524A4456;  // "VDJR"
+    static constexpr uint32_t kVersion   = 1;
+    static constexpr uint32_t kSlotCount = 64;
+    static constexpr uint32_t kSlotSize  = 4096;
+    static constexpr size_t   kHeaderSize     = 64;
+    static constexpr size_t   kSlotHeaderSize = 16;
+    static constexpr size_t   kFileSize = kHeaderSize + size_t{kSlotCount} * kSlotSize;
+    static constexpr int64_t  kReaderTimeoutMs = 1000;
+
+private:
+    unsigned char* base_ = nullptr;
+    uint64_t       next_ = 0;   // index of the next record
+#ifdef _WIN32
+    void*          file_    = nullptr;
+    void*          mapping_ = nullptr;
+#else
+    int            fd_ = -1;
+#endif
+};
@@ -0,0 +1,25 @@
+//////////////////////////////////////////////////////////////////////////
+// UdpClient – implementation
+//////////////////////////////////////////////////////////////////////////
+
+#include "UdpClient.h"
+
+UdpClient::~UdpClient() {
+    close();
+}
+
+bool UdpClient::open(const std::string& address, int port) {
+    close();
+    sock_ = net::connectUdp(address, port);
+    return isOpen();
+}
+
+void UdpClient::close() {
+    net::closeSocket(sock_);
+    sock_ = net::kInvalidSocket;
+}
+
+bool UdpClient::send(const std::string& payload) {
+    if (!isOpen() || payload.size() > kMaxDatagram) return false;
+    return net::sendDatagram(sock_, payload.data(), payload.size());
+}
@@ -0,0 +1,34 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// UdpClient – fire-and-forget datagram sender
+//
+// One connected UDP socket for pushing complete deck frames to the
+// server.  Nothing is acknowledged or retransmitted: every frame carries
+// the full state, so a lost datagram is repaired by the next one.
+//
+// Not thread-safe: owned by the sending thread (through ServerLink).
+//////////////////////////////////////////////////////////////////////////
+
+#include "NetSocket.h"
+
+#include <string>
+
+class UdpClient {
+public:
+    UdpClient() = default;
+    ~UdpClient();
+
+    bool open(const std::string& address, int port);
+    void close();
+    bool isOpen() const { return sock_ != net::kInvalidSocket; }
+
+    // Sends one datagram. False if it is too large or the send failed
+    // (e.g. the server's UDP port is closed); the socket stays open.
+    bool send(const std::string& payload);
+
+    // Largest payload an IPv4 UDP datagram can carry.
+    static constexpr size_t kMaxDatagram = 65507;
+
+private:
+    net::socket_t sock_ = net::kInvalidSocket;
+};
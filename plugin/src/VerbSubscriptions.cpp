@@ -0,0 +1,149 @@
+//////////////////////////////////////////////////////////////////////////
+// VerbSubscriptions – implementation
+//////////////////////////////////////////////////////////////////////////
+
+#include "VerbSubscriptions.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+// The server writes the list with encoding/json from a fixed struct, so
+// the fields come in order and verbs never contain quotes or backslashes
+// (it drops such verbs); finding the keys is enough.
+bool VerbSubscriptions::setList(const std::string& json) {
+    size_t pos = json.find("\"version\":");
+    if (pos == std::string::npos) return false;
+    uint32_t version = static_cast<uint32_t>(std::strtoul(json.c_str() + pos + 10, nullptr, 10));
+    if (json.find("\"verbs\":") == std::string::npos) return false;
+
+    Verb parsed[kMaxVerbs];
+    int n = 0;
+    static const char kVerbKey[] = "\"verb\":\"";
+    while (n < kMaxVerbs && (pos = json.find(kVerbKey, pos)) != std::string::npos) {
+        size_t start = pos + sizeof(kVerbKey) - 1;
+        size_t end = json.find('"', start);
+        if (end == std::string::npos) return false;
+        pos = end;
+        if (end == start || end - start >= kVerbSize) continue;
+
+        // The rest of this verb's object runs up to the next verb.
+        size_t next = json.find(kVerbKey, end);
+        std::string rest = json.substr(end, next == std::string::npos ? std::string::npos : next - end);
+        Verb& v = parsed[n++];
+        json.copy(v.name, end - start, start);
+        v.name[end - start] = '\0';
+        v.global = rest.find("\"scope\":\"global\"") != std::string::npos;
+        size_t interval = rest.find("\"intervalMs\":");
+        long ms = interval == std::string::npos ? 0 : std::strtol(rest.c_str() + interval + 13, nullptr, 10);
+        v.intervalUs = (ms > 0 ? ms : 500) * 1000LL;
+    }
+
+    std::lock_guard<std::mutex> lock(mu_);
+    for (int i = 0; i < n; ++i) staged_[i] = parsed[i];
+    stagedCount_ = n;
+    stagedNew_ = true;
+    version_ = version;
+    return true;
+}
+
+void VerbSubscriptions::resendAll() {
+    std::lock_guard<std::mutex> lock(mu_);
+    for (int i = 0; i < count_; ++i) {
+        for (int d = 0; d < kMaxDecks; ++d) {
+            table_[i].dirty[d] = table_[i].dirty[d] || table_[i].value[d][0] != '\0';
+        }
+    }
+}
+
+int VerbSubscriptions::take(Change* out, int max) {
+    std::lock_guard<std::mutex> lock(mu_);
+    int n = 0;
+    for (int i = 0; i < count_ && n < max; ++i) {
+        Entry& e = table_[i];
+        for (int d = 0; d < kMaxDecks && n < max; ++d) {
+            if (!e.dirty[d]) continue;
+            e.dirty[d] = false;
+            Change& c = out[n++];
+            std::memcpy(c.verb, e.verb.name, sizeof(c.verb));
+            c.deck = e.verb.global ? 0 : d + 1;
+            std::memcpy(c.value, e.value[d], sizeof(c.value));
+        }
+    }
+    return n;
+}
+
+bool VerbSubscriptions::poll(int64_t nowUs, const bool loaded[kMaxDecks]) {
+    {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (stagedNew_) {
+            // Verbs kept from the old list keep their values, so the
+            // server is not told about a change that didn't happen.
+            // The new table is built in fresh_, not on the heap.
+            for (int i = 0; i < stagedCount_; ++i) {
+                Entry& e = fresh_[i];
+                e = Entry{};
+                e.verb = staged_[i];
+                for (int old = 0; old < count_; ++old) {
+                    const Entry& o = table_[old];
+                    if (o.verb.global != e.verb.global || std::strcmp(o.verb.name, e.verb.name) != 0) continue;
+                    std::memcpy(e.value, o.value, sizeof(e.value));
+                    std::memcpy(e.dirty, o.dirty, sizeof(e.dirty));
+                }
+                // Formatted from a local copy of the name: with both in
+                // e, GCC cannot rule out an overlap (-Wrestrict).
+                char name[kVerbSize];
+                std::memcpy(name, e.verb.name, sizeof(name));
+                name[sizeof(name) - 1] = '\0';
+                int queries = e.verb.global ? 1 : kMaxDecks;
+                for (int d = 0; d < queries; ++d) {
+                    if (e.verb.global) std::snprintf(e.query[d], sizeof(e.query[d]), "%s", name);
+                    else               std::snprintf(e.query[d], sizeof(e.query[d]), "deck %d %s", d + 1, name);
+                }
+            }
+            for (int i = 0; i < stagedCount_; ++i) table_[i] = fresh_[i];
+            count_ = stagedCount_;
+            stagedNew_ = false;
+            subscribed_ = count_;
+        }
+    }
+
+    bool changed = false;
+    for (int i = 0; i < count_; ++i) {
+        Entry& e = table_[i];
+        if (nowUs < e.nextUs) continue;
+        e.nextUs = nowUs + e.verb.intervalUs;
+
+        int queries = e.verb.global ? 1 : kMaxDecks;
+        for (int d = 0; d < queries; ++d) {
+            // An empty deck reads as no value without asking the host.
+            std::memset(buf_, 0, sizeof(buf_));
+            if (e.verb.global || loaded[d]) {
+                calls_++;
+                reads_++;
+                if (vdj_.GetStringInfo(e.query[d], buf_, sizeof(buf_)) != S_OK) continue;
+                buf_[sizeof(buf_) - 1] = '\0';
+            }
+            if (std::strcmp(buf_, e.value[d]) == 0) continue;
+
+            std::lock_guard<std::mutex> lock(mu_);
+            std::memcpy(e.value[d], buf_, sizeof(buf_));
+            e.dirty[d] = true;
+            changes_++;
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+std::string VerbSubscriptions::statsJson() const {
+    std::ostringstream ss;
+    ss << "{"
+       << "\"version\":" << version_.load() << ","
+       << "\"subscribed\":" << subscribed_.load() << ","
+       << "\"reads\":" << reads_.load() << ","
+       << "\"changes\":" << changes_.load()
+       << "}";
+    return ss.str();
+}
@@ -0,0 +1,91 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// VerbSubscriptions – extra VDJ verbs polled on the server's behalf
+//
+// Overlay elements on the server can be bound to any VDJ verb, not only
+// to the DeckState fields.  The server derives a subscription list from
+// the enabled ones,
+//
+//   {"version":123,"verbs":[{"verb":"get_key","scope":"deck","intervalMs":500},...]}
+//
+// which the sender fetches from /api/plugin/subscriptions on connect and
+// whenever the server announces another version.  The poll tick reads
+// each subscribed verb as text at its own interval, once per loaded deck
+// ("deck N verb") or once for the mixer ("verb"), and keeps the values
+// that changed for the sender to post to /api/plugin/verbs.  With
+// nothing subscribed, nothing is read.
+//
+// setList(), resendAll() and take() run on the sender thread, poll() on
+// the poll tick; mu_ hands the table between them.
+//////////////////////////////////////////////////////////////////////////
+
+#include "vdjPlugin8.h"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+class VerbSubscriptions {
+public:
+    static constexpr int kMaxVerbs  = 16;   // server: models.MaxSubscriptions
+    static constexpr int kMaxDecks  = 8;
+    static constexpr int kVerbSize  = 64;
+    static constexpr int kValueSize = 256;
+
+    // A changed value.  deck is 0 for a global verb.
+    struct Change {
+        char verb[kVerbSize];
+        int  deck;
+        char value[kValueSize];
+    };
+
+    VerbSubscriptions(IVdjPlugin8& vdj, std::atomic<uint64_t>& calls) : vdj_(vdj), calls_(calls) {}
+
+    // Replaces the list with a /api/plugin/subscriptions reply, applied
+    // at the next poll.  False (the old list stays) if it doesn't parse.
+    bool setList(const std::string& json);
+    // Version of the last list set; 0 before the first.
+    uint32_t version() const { return version_.load(); }
+    // Marks every known value changed, e.g. for a restarted server.
+    void resendAll();
+    // Moves up to max changed values into out; returns how many.
+    int take(Change* out, int max);
+
+    // Reads the verbs that are due.  loaded[d] says whether deck d+1
+    // holds a track of its own.  True if a value changed.
+    bool poll(int64_t nowUs, const bool loaded[kMaxDecks]);
+
+    std::string statsJson() const;
+
+private:
+    struct Verb {
+        char    name[kVerbSize] = {};
+        bool    global = false;
+        int64_t intervalUs = 0;
+    };
+    struct Entry {
+        Verb    verb;
+        int64_t nextUs = 0;
+        char    query[kMaxDecks][kVerbSize + 16] = {};  // "deck N verb"; [0] only when global
+        char    value[kMaxDecks][kValueSize] = {};
+        bool    dirty[kMaxDecks] = {};
+    };
+
+    IVdjPlugin8&           vdj_;
+    std::atomic<uint64_t>& calls_;
+
+    std::mutex             mu_;
+    Verb                   staged_[kMaxVerbs];  // guarded by mu_
+    int                    stagedCount_ = 0;
+    bool                   stagedNew_ = false;
+    Entry                  table_[kMaxVerbs];   // layout: poll tick; values/dirty: mu_
+    Entry                  fresh_[kMaxVerbs];   // poll tick: the next table while it is built
+    int                    count_ = 0;
+    char                   buf_[kValueSize] = {};  // poll tick
+
+    std::atomic<uint32_t>  version_{0};
+    std::atomic<int>       subscribed_{0};
+    std::atomic<uint64_t>  reads_{0};
+    std::atomic<uint64_t>  changes_{0};
+};
@@ -2,15 +2,20 @@
 // VdjVideoSync Plugin – implementation
 //////////////////////////////////////////////////////////////////////////
 
-#define CPPHTTPLIB_NO_EXCEPTIONS
 #include "VideoSyncPlugin.h"
-#include "httplib.h"
+#include "AllocGuard.h"
 
+#include <algorithm>
 #include <cstdio>
+#include <cstring>
+#include <charconv>
 #include <chrono>
+#include <cmath>
 #include <sstream>
 #include <cstdlib>
 #include <cctype>
+#include <random>
+#include <vector>
 
 // ── Input validation ───────────────────────────────────
 // Rejects garbage / malicious input from set_var_dialog.
@@ -37,16 +42,191 @@ static bool isValidPort(const char* s) {
     return v >= 1 && v <= 65535;
 }
 
-// ── Locale-safe float-to-string ─────────────────────────
-// Ensures decimal separator is always '.' regardless of system locale.
-static std::string floatToStr(double v) {
-    char buf[64];
-    std::snprintf(buf, sizeof(buf), "%.6f", v);
-    // Force dot separator (in case snprintf used comma)
-    for (char* p = buf; *p; ++p) {
-        if (*p == ',') *p = '.';
+// Accepts a known transport name ("http", "ws", "udp" or "shm").
+static bool isValidTransport(const char* s) {
+    Transport t;
+    return parseTransport(s, t);
+}
+
+// Parses "volume/pitch/bpm[/position]" deadbands: non-negative decimals
+// such as "0.001/0.01/0.01/15".  The position tolerance (ms) is optional
+// so three-value settings from older versions keep working.  Hand-rolled
+// so a comma locale can't change it.
+static bool parseDeadbands(const char* s, double out[4]) {
+    if (!s) return false;
+    out[3] = kDefaultPositionToleranceMs;
+    for (int i = 0; i < 4; ++i) {
+        double v = 0.0, scale = 0.0;
+        int digits = 0;
+        for (; *s; ++s) {
+            if (std::isdigit(static_cast<unsigned char>(*s))) {
+                if (scale > 0.0) { v += (*s - '0') * scale; scale /= 10.0; }
+                else             { v = v * 10.0 + (*s - '0'); }
+                ++digits;
+            } else if (*s == '.' && scale == 0.0) {
+                scale = 0.1;
+            } else {
+                break;
+            }
+        }
+        if (digits == 0 || digits > 12) return false;
+        out[i] = v;
+        if (i == 2 && *s == '\0') return true;
+        if (i < 3 && *s++ != '/') return false;
+    }
+    return *s == '\0';
+}
+
+static bool isValidDeadbands(const char* s) {
+    double v[4];
+    return parseDeadbands(s, v);
+}
+
+// Parses "idle/nominal/burst/hold" poll rates in ms, e.g. "500/50/10/500".
+// The intervals must not increase from idle to burst, which is at least
+// 5ms; idle is at most 5s and the burst hold at most 10s.
+static bool parsePollRates(const char* s, int out[4]) {
+    if (!s) return false;
+    for (int i = 0; i < 4; ++i) {
+        int v = 0, digits = 0;
+        for (; std::isdigit(static_cast<unsigned char>(*s)); ++s) {
+            v = v * 10 + (*s - '0');
+            if (++digits > 5) return false;
+        }
+        if (digits == 0) return false;
+        out[i] = v;
+        if (i < 3 && *s++ != '/') return false;
+    }
+    return *s == '\0' && out[2] >= 5 && out[2] <= out[1] && out[1] <= out[0]
+        && out[0] <= 5000 && out[3] <= 10000;
+}
+
+static bool isValidPollRates(const char* s) {
+    int v[4];
+    return parsePollRates(s, v);
+}
+
+// One extra endpoint from the Endpoints parameter.
+struct EndpointSpec {
+    std::string host;
+    std::string port;
+    int         maxHz = 0;  // 0 = send every update
+};
+
+// Parses "host:port[@hz]" entries separated by commas (spaces allowed),
+// or "none".  Returns the number of entries, or -1 if any is invalid or
+// there are more than max.
+static int parseEndpoints(const char* s, EndpointSpec* out, int max) {
+    if (!s) return -1;
+    if (std::strcmp(s, "none") == 0) return 0;
+    int count = 0;
+    while (*s) {
+        while (*s == ' ') ++s;
+        const char* end = s;
+        while (*end && *end != ',') ++end;
+        std::string entry(s, end);
+        while (!entry.empty() && entry.back() == ' ') entry.pop_back();
+        s = *end ? end + 1 : end;
+
+        EndpointSpec spec;
+        size_t at = entry.find('@');
+        if (at != std::string::npos) {
+            std::string hz = entry.substr(at + 1);
+            if (hz.empty() || hz.size() > 4
+                || hz.find_first_not_of("0123456789") != std::string::npos) return -1;
+            spec.maxHz = std::atoi(hz.c_str());
+            if (spec.maxHz < 1 || spec.maxHz > 1000) return -1;
+            entry.resize(at);
+        }
+        size_t colon = entry.rfind(':');
+        if (colon == std::string::npos) return -1;
+        spec.host = entry.substr(0, colon);
+        spec.port = entry.substr(colon + 1);
+        if (!isValidHost(spec.host.c_str()) || !isValidPort(spec.port.c_str())) return -1;
+        if (count == max) return -1;
+        out[count++] = spec;
+    }
+    return count;
+}
+
+static bool isValidEndpoints(const char* s) {
+    EndpointSpec specs[8];
+    return parseEndpoints(s, specs, 8) >= 0;
+}
+
+// ── Allocation-free JSON writers ────────────────────────
+// Append straight into a reused buffer: no streams, no temporaries, and
+// the decimal separator is always '.' regardless of system locale.
+
+static void appendInt(std::string& out, long long v) {
+    char buf[24];
+    auto res = std::to_chars(buf, buf + sizeof(buf), v);
+    out.append(buf, res.ptr);
+}
+
+// Same bytes as printf("%.6f").  Shortest round-trip (std::to_chars for
+// double) would change the wire output and is unavailable on the macOS
+// 10.13 deployment target, so values are scaled to integer micro-units
+// instead.  Exact .5 ties after scaling and huge or non-finite values go
+// through snprintf to keep its rounding.
+static void appendFixed6(std::string& out, double v) {
+    double scaled = v * 1e6;
+    double whole = std::floor(std::fabs(scaled));
+    if (std::fabs(scaled) < 1e12 && std::fabs(std::fabs(scaled) - whole - 0.5) > 1e-3) {
+        long long units = std::llround(std::fabs(scaled));
+        if (std::signbit(v)) out += '-';  // printf keeps the sign of -0.0 too
+        appendInt(out, units / 1000000);
+        char frac[8];
+        long long rem = units % 1000000;
+        for (int i = 6; i >= 1; --i, rem /= 10) frac[i] = static_cast<char>('0' + rem % 10);
+        frac[0] = '.';
+        out.append(frac, 7);
+        return;
+    }
+
+    char buf[350];  // enough for %.6f of DBL_MAX
+    int n = std::snprintf(buf, sizeof(buf), "%.6f", v);
+    for (int i = 0; i < n; ++i) {
+        if (buf[i] == ',') buf[i] = '.';
+    }
+    out.append(buf, n > 0 ? static_cast<size_t>(n) : 0);
+}
+
+// Appends size bytes of text as a JSON string literal, escaping quotes,
+// backslashes and every control character below 0x20.
+static void appendJsonString(std::string& out, const char* text, size_t size) {
+    static const char* hex = "0123456789abcdef";
+    out += '"';
+    size_t run = 0;  // start of the pending unescaped run
+    for (size_t i = 0; i < size; ++i) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (c >= 0x20 && c != '"' && c != '\\') continue;
+        out.append(text + run, i - run);
+        run = i + 1;
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\b': out += "\\b";  break;
+            case '\f': out += "\\f";  break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default: {
+                char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                out.append(esc, sizeof(esc));
+            }
+        }
     }
-    return buf;
+    out.append(text + run, size - run);
+    out += '"';
+}
+
+static void appendJsonString(std::string& out, const char* s) {
+    appendJsonString(out, s, std::strlen(s));
+}
+
+static void appendJsonString(std::string& out, const DeckText& s) {
+    appendJsonString(out, s.data(), s.size());
 }
 
 // ── DeckState helpers ───────────────────────────────────
@@ -62,43 +242,158 @@ bool DeckState::operator==(const DeckState& o) const {
         && totalTimeMs == o.totalTimeMs
         && title == o.title
         && artist == o.artist;
-    // elapsedMs is intentionally excluded – it changes every frame
+    // elapsedMs is intentionally excluded – it changes every frame.
+    // The text fields compare their hashes first (see FixedString).
 }
 
 std::string DeckState::toJson() const {
-    std::ostringstream ss;
-    auto escape = [](const std::string& s) -> std::string {
-        std::string out;
-        out.reserve(s.size() + 8);
-        for (char c : s) {
-            switch (c) {
-                case '"':  out += "\\\""; break;
-                case '\\': out += "\\\\"; break;
-                case '\n': out += "\\n";  break;
-                case '\r': out += "\\r";  break;
-                case '\t': out += "\\t";  break;
-                default:   out += c;
-            }
-        }
-        return out;
-    };
+    std::string out;
+    appendJson(out);
+    return out;
+}
+
+// Fields missing from a delta record are simply omitted; the server
+// keeps its value from the snapshot of the same track.
+void DeckState::appendJson(std::string& out, uint16_t fields, uint32_t track) const {
+    out += "{\"deck\":";
+    appendInt(out, deck);
+    if (track != 0) {
+        out += ",\"track\":";
+        appendInt(out, track);
+    }
+    out += isAudible ? ",\"isAudible\":true" : ",\"isAudible\":false";
+    out += isPlaying ? ",\"isPlaying\":true" : ",\"isPlaying\":false";
+    if (fields & FIELD_VOLUME) {
+        out += ",\"volume\":";
+        appendFixed6(out, volume);
+    }
+    if (fields & FIELD_ELAPSED) {
+        out += ",\"elapsedMs\":";
+        appendInt(out, elapsedMs);
+    }
+    if (fields & FIELD_BPM) {
+        out += ",\"bpm\":";
+        appendFixed6(out, bpm);
+    }
+    if (fields & FIELD_FILENAME) {
+        out += ",\"filename\":";
+        appendJsonString(out, filename);
+    }
+    if (fields & FIELD_PITCH) {
+        out += ",\"pitch\":";
+        appendFixed6(out, pitch);
+    }
+    if (fields & FIELD_TOTAL_TIME) {
+        out += ",\"totalTimeMs\":";
+        appendInt(out, totalTimeMs);
+    }
+    if (fields & FIELD_TITLE) {
+        out += ",\"title\":";
+        appendJsonString(out, title);
+    }
+    if (fields & FIELD_ARTIST) {
+        out += ",\"artist\":";
+        appendJsonString(out, artist);
+    }
+    out += '}';
+}
+
+// ── Binary wire format ──────────────────────────────────
+// Sent with Content-Type kDeckBinaryType (or as a WebSocket binary
+// message / UDP datagram / ring record) when the server advertises it.  All numbers
+// are little-endian; server/internal/models/wire.go is the decoder.
+//
+//   frame:  u8 version (2), u8 deckCount, u16 reserved,
+//           u32 session, u64 seq, i64 captureUs        (24 bytes)
+//   deck:   u8 deck, u8 flags (1 = audible, 2 = playing),
+//           u16 fields (FIELD_* bits), u32 track       (8 bytes)
+//           then, only for the bits set in fields and in this order:
+//           i32 elapsedMs, i32 totalTimeMs, f64 volume, f64 bpm,
+//           f64 pitch, and filename, title, artist as u16 length + UTF-8
+//
+// Version 1 had no track and always carried every field.
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "the binary deck format is written in host byte order, which must be little-endian"
+#endif
+
+static constexpr uint8_t kWireVersion = 2;
+
+template <typename T>
+static void putRaw(std::string& out, T v) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &v, sizeof(T));
+    out.append(bytes, sizeof(T));
+}
 
+static void putString(std::string& out, const DeckText& s) {
+    putRaw(out, static_cast<uint16_t>(s.size()));  // FixedString keeps it below 0xFFFF
+    out.append(s.data(), s.size());
+}
+
+void DeckState::appendBinary(std::string& out, uint16_t fields, uint32_t track) const {
+    uint8_t flags = (isAudible ? 1 : 0) | (isPlaying ? 2 : 0);
+    putRaw(out, static_cast<uint8_t>(deck));
+    putRaw(out, flags);
+    putRaw(out, fields);
+    putRaw(out, track);
+    if (fields & FIELD_ELAPSED)    putRaw(out, static_cast<int32_t>(elapsedMs));
+    if (fields & FIELD_TOTAL_TIME) putRaw(out, static_cast<int32_t>(totalTimeMs));
+    if (fields & FIELD_VOLUME)     putRaw(out, volume);
+    if (fields & FIELD_BPM)        putRaw(out, bpm);
+    if (fields & FIELD_PITCH)      putRaw(out, pitch);
+    if (fields & FIELD_FILENAME)   putString(out, filename);
+    if (fields & FIELD_TITLE)      putString(out, title);
+    if (fields & FIELD_ARTIST)     putString(out, artist);
+}
+
+std::string SendCounters::toJson() const {
+    std::ostringstream ss;
     ss << "{"
-       << "\"deck\":" << deck << ","
-       << "\"isAudible\":" << (isAudible ? "true" : "false") << ","
-       << "\"isPlaying\":" << (isPlaying ? "true" : "false") << ","
-       << "\"volume\":" << floatToStr(volume) << ","
-       << "\"elapsedMs\":" << elapsedMs << ","
-       << "\"bpm\":" << floatToStr(bpm) << ","
-       << "\"filename\":\"" << escape(filename) << "\","
-       << "\"pitch\":" << floatToStr(pitch) << ","
-       << "\"totalTimeMs\":" << totalTimeMs << ","
-       << "\"title\":\"" << escape(title) << "\","
-       << "\"artist\":\"" << escape(artist) << "\""
+       << "\"published\":" << published.load() << ","
+       << "\"coalesced\":" << coalesced.load() << ","
+       << "\"sent\":" << sent.load() << ","
+       << "\"dropped\":" << dropped.load() << ","
+       << "\"requests\":" << requests.load() << ","
+       << "\"snapshots\":" << snapshots.load() << ","
+       << "\"deltas\":" << deltas.load() << ","
+       << "\"resyncs\":" << resyncs.load() << ","
+       << "\"predicted\":" << predicted.load() << ","
+       << "\"throttled\":" << throttled.load() << ","
+       << "\"clockSyncs\":" << clockSyncs.load() << ","
+       << "\"vdjCalls\":" << vdjCalls.load() << ","
+       << "\"vdjCallsPerSec\":" << vdjCallsPerSec.load()
        << "}";
     return ss.str();
 }
 
+// ── Process-wide engine registry ────────────────────────
+
+namespace {
+
+// Loaded instances in load order and the one hosting the engine,
+// guarded by mu, plus counters for the stats.  These are atomics so the
+// host's sender can report them without mu.  handover serializes the
+// engine moves themselves, which start and join threads and so run
+// after mu is released.  A function-local static so it exists before
+// the first DllGetClassObject() however the DLL's statics initialise.
+struct EngineRegistry {
+    std::mutex                     handover;
+    std::mutex                     mu;
+    std::vector<CVideoSyncPlugin*> instances;
+    CVideoSyncPlugin*              host = nullptr;
+    std::atomic<int>               loaded{0};
+    std::atomic<int>               enabled{0};
+    std::atomic<uint64_t>          handovers{0};
+};
+
+EngineRegistry& engineRegistry() {
+    static EngineRegistry registry;
+    return registry;
+}
+
+} // namespace
+
 // ── Constructor / Destructor ────────────────────────────
 
 CVideoSyncPlugin::CVideoSyncPlugin()  = default;
@@ -110,24 +405,40 @@ HRESULT VDJ_API CVideoSyncPlugin::OnLoad() {
     // String params: displayed in VDJ UI and persisted in .ini
     DeclareParameterString(paramIP_,   PARAM_IP,   "Server IP",   "IP",   kParamSize);
     DeclareParameterString(paramPort_, PARAM_PORT, "Server Port", "Port", kParamSize);
+    DeclareParameterString(paramTransport_, PARAM_TRANSPORT, "Transport", "TRN", kParamSize);
+    DeclareParameterString(paramDeadbands_, PARAM_DEADBANDS, "Deadbands", "DBD", kParamSize);
+    DeclareParameterString(paramEndpoints_, PARAM_ENDPOINTS, "Endpoints", "EPS", kEndpointsParamSize);
+    DeclareParameterString(paramPollRates_, PARAM_POLL_RATES, "Poll Rates", "PLR", kParamSize);
 
     // Buttons open native VDJ dialogs for IP / Port (cross-platform)
     DeclareParameterButton(&setIpBtn_,   PARAM_SET_IP,   "Set IP",   "SIP");
     DeclareParameterButton(&setPortBtn_, PARAM_SET_PORT, "Set Port",  "SPT");
+    DeclareParameterButton(&setTransportBtn_, PARAM_SET_TRANSPORT, "Set Transport", "STR");
+    DeclareParameterButton(&setDeadbandsBtn_, PARAM_SET_DEADBANDS, "Set Deadbands", "SDB");
+    DeclareParameterButton(&setEndpointsBtn_, PARAM_SET_ENDPOINTS, "Set Endpoints", "SEP");
+    DeclareParameterButton(&setPollRatesBtn_, PARAM_SET_POLL_RATES, "Set Poll Rates", "SPR");
 
-    // VDJ persistent vars survive across plugin reloads.
+    // The .ini values VDJ just loaded into the buffers are the first
+    // snapshot.  VDJ persistent vars survive across plugin reloads.
     // If the user previously changed values via set_var_dialog, those
     // vars will still hold the new values.  Read them first so they
     // take precedence over stale .ini defaults, then sync back.
+    publishConfig(configFromParams());
     applyVarChanges();
     pushParamsToVars();
 
-    // Start always-on settings watcher (polls VDJ vars even when disabled)
-    watcherRunning_ = true;
-    settingsWatcher_ = std::thread(&CVideoSyncPlugin::settingsWatchLoop, this);
+    queries_.compile(kDefaultDecks);  // until the poll has probed the layout
+    applyPollRates();
+    applyDeadbands();
 
-    // Create the HTTP client with current parameters
-    recreateClient();
+    // The scheduler, link and endpoints exist only while this instance
+    // hosts the engine (see hostEngine()).
+    EngineRegistry& registry = engineRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mu);
+        registry.instances.push_back(this);
+    }
+    rebalanceEngine();
     return S_OK;
 }
 
@@ -148,80 +459,191 @@ HRESULT VDJ_API CVideoSyncPlugin::OnParameter(int id) {
         applyVarChanges();
         setPortBtn_ = 0;
     }
+    if (id == PARAM_SET_TRANSPORT && setTransportBtn_ == 1) {
+        pushParamsToVars();
+        SendCommand("set_var_dialog $vdjVideoSyncTransport 'Enter Transport (http, ws, udp or shm)'");
+        applyVarChanges();
+        setTransportBtn_ = 0;
+    }
+    if (id == PARAM_SET_DEADBANDS && setDeadbandsBtn_ == 1) {
+        pushParamsToVars();
+        SendCommand("set_var_dialog $vdjVideoSyncDeadbands 'Enter Deadbands (volume/pitch/bpm/position ms)'");
+        applyVarChanges();
+        setDeadbandsBtn_ = 0;
+    }
+    if (id == PARAM_SET_ENDPOINTS && setEndpointsBtn_ == 1) {
+        pushParamsToVars();
+        SendCommand("set_var_dialog $vdjVideoSyncEndpoints 'Enter extra endpoints (host:port[@hz], comma separated, or none)'");
+        applyVarChanges();
+        setEndpointsBtn_ = 0;
+    }
+    if (id == PARAM_SET_POLL_RATES && setPollRatesBtn_ == 1) {
+        pushParamsToVars();
+        SendCommand("set_var_dialog $vdjVideoSyncPollRates 'Enter Poll Rates (idle/nominal/burst/hold ms)'");
+        applyVarChanges();
+        setPollRatesBtn_ = 0;
+    }
+    syncParamBuffers();
     return S_OK;
 }
 
 HRESULT VDJ_API CVideoSyncPlugin::OnGetParameterString(int id, char* outParam, int outParamSize) {
-    // Pick up any dialog results (runs on VDJ's UI thread, even when disabled)
-    applyVarChanges();
-
-    // Show current IP/Port as button labels
+    // Dialog results are picked up by the settings task within 200ms.
+    // Show current IP/Port/Transport/Deadbands/Endpoints/Poll Rates as
+    // button labels, from the snapshot: no host calls, no locks held
+    // by other threads.
+    auto config = this->config();
+    const std::string* value = nullptr;
     switch (id) {
-        case PARAM_SET_IP:
-            strncpy(outParam, paramIP_, outParamSize);
-            outParam[outParamSize - 1] = '\0';
-            return S_OK;
-        case PARAM_SET_PORT:
-            strncpy(outParam, paramPort_, outParamSize);
-            outParam[outParamSize - 1] = '\0';
-            return S_OK;
+        case PARAM_SET_IP:         value = &config->ip;        break;
+        case PARAM_SET_PORT:       value = &config->port;      break;
+        case PARAM_SET_TRANSPORT:  value = &config->transport; break;
+        case PARAM_SET_DEADBANDS:  value = &config->deadbands; break;
+        case PARAM_SET_ENDPOINTS:  value = &config->endpoints; break;
+        case PARAM_SET_POLL_RATES: value = &config->pollRates; break;
         default:
             return E_NOTIMPL;
     }
+    strncpy(outParam, value->c_str(), outParamSize);
+    outParam[outParamSize - 1] = '\0';
+    syncParamBuffers();
+    return S_OK;
+}
+
+// ── Configuration snapshot ──────────────────────────────
+
+CVideoSyncPlugin::ConfigPtr CVideoSyncPlugin::config() const {
+    return std::atomic_load(&config_);
+}
+
+void CVideoSyncPlugin::publishConfig(const PluginConfig& config) {
+    std::atomic_store(&config_, std::make_shared<const PluginConfig>(config));
+}
+
+CVideoSyncPlugin::PluginConfig CVideoSyncPlugin::configFromParams() const {
+    PluginConfig config;
+    config.ip        = paramIP_;
+    config.port      = paramPort_;
+    config.transport = paramTransport_;
+    config.deadbands = paramDeadbands_;
+    config.endpoints = paramEndpoints_;
+    config.pollRates = paramPollRates_;
+    return config;
+}
+
+// Copies the snapshot into the buffers VDJ displays and saves to the
+// .ini.  VDJ reads them on its own thread, so this runs only there.
+void CVideoSyncPlugin::syncParamBuffers() {
+    auto config = this->config();
+    auto copy = [](char* dst, const std::string& src, int size) {
+        strncpy(dst, src.c_str(), size);
+        dst[size - 1] = '\0';
+    };
+    copy(paramIP_,        config->ip,        kParamSize);
+    copy(paramPort_,      config->port,      kParamSize);
+    copy(paramTransport_, config->transport, kParamSize);
+    copy(paramDeadbands_, config->deadbands, kParamSize);
+    copy(paramEndpoints_, config->endpoints, kEndpointsParamSize);
+    copy(paramPollRates_, config->pollRates, kParamSize);
+}
+
+// Never blocks: the link resolves and reconnects on the sender thread,
+// after the request in flight.  Called with varsMu_ held; a no-op while
+// this instance does not host the engine.
+void CVideoSyncPlugin::updateEndpoint() {
+    if (!engine_) return;
+    auto config = this->config();
+    Transport transport = Transport::Http;
+    parseTransport(config->transport.c_str(), transport);
+    engine_->link.setEndpoint(config->ip, config->port, transport);
+}
+
+// Publishes the deadband parameter to the sender thread.
+void CVideoSyncPlugin::applyDeadbands() {
+    double v[4];
+    if (!parseDeadbands(config()->deadbands.c_str(), v)) return;
+    deadbandVolume_ = v[0];
+    deadbandPitch_  = v[1];
+    deadbandBpm_    = v[2];
+    positionToleranceMs_ = v[3];
 }
 
-void CVideoSyncPlugin::recreateClient() {
-    std::lock_guard<std::mutex> lock(httpMutex_);
-    delete httpClient_;
-    std::string endpoint = std::string("http://") + paramIP_ + ":" + paramPort_;
-    httpClient_ = new httplib::Client(endpoint);
-    httpClient_->set_connection_timeout(2);
-    httpClient_->set_read_timeout(2);
+// Publishes the poll rate parameter to the poll tick, which applies it
+// on its next run.
+void CVideoSyncPlugin::applyPollRates() {
+    int v[4];
+    if (!parsePollRates(config()->pollRates.c_str(), v)) return;
+    pollIdleMs_    = v[0];
+    pollNominalMs_ = v[1];
+    pollBurstMs_   = v[2];
+    pollHoldMs_    = v[3];
+}
+
+// Points the fan-out endpoints at the Endpoints parameter; unused ones
+// are disabled.  Never blocks: each endpoint reconnects on its own thread.
+// Like updateEndpoint(), only for the host, with varsMu_ held.
+void CVideoSyncPlugin::applyEndpoints() {
+    if (!engine_) return;
+    EndpointSpec specs[kMaxFanout];
+    int count = parseEndpoints(config()->endpoints.c_str(), specs, kMaxFanout);
+    if (count < 0) return;
+    for (int i = 0; i < kMaxFanout; ++i) {
+        if (i < count) engine_->fanout[i].configure(specs[i].host, specs[i].port, specs[i].maxHz);
+        else           engine_->fanout[i].configure("", "", 0);
+    }
 }
 
 // ── VDJ Variable Sync ───────────────────────────────────
-// VDJ persistent vars (@$) mirror the param buffers so that
+// VDJ persistent vars (@$) mirror the configuration so that
 // set_var_dialog can show / edit the current values.
 
 void CVideoSyncPlugin::pushParamsToVars() {
-    char cmd[256];
-    std::snprintf(cmd, sizeof(cmd), "set $vdjVideoSyncAddr '%s'", paramIP_);
+    auto config = this->config();
+    char cmd[kEndpointsParamSize + 64];
+    std::snprintf(cmd, sizeof(cmd), "set $vdjVideoSyncAddr '%s'", config->ip.c_str());
+    SendCommand(cmd);
+    std::snprintf(cmd, sizeof(cmd), "set $vdjVideoSyncPort '%s'", config->port.c_str());
+    SendCommand(cmd);
+    std::snprintf(cmd, sizeof(cmd), "set $vdjVideoSyncTransport '%s'", config->transport.c_str());
+    SendCommand(cmd);
+    std::snprintf(cmd, sizeof(cmd), "set $vdjVideoSyncDeadbands '%s'", config->deadbands.c_str());
     SendCommand(cmd);
-    std::snprintf(cmd, sizeof(cmd), "set $vdjVideoSyncPort '%s'", paramPort_);
+    std::snprintf(cmd, sizeof(cmd), "set $vdjVideoSyncEndpoints '%s'", config->endpoints.c_str());
+    SendCommand(cmd);
+    std::snprintf(cmd, sizeof(cmd), "set $vdjVideoSyncPollRates '%s'", config->pollRates.c_str());
     SendCommand(cmd);
 }
 
 void CVideoSyncPlugin::applyVarChanges() {
-    // Read VDJ persistent vars and update param buffers if the user
-    // changed them via set_var_dialog (which is non-blocking).
-    char buf[64] = {};
-    bool changed = false;
-
-    if (GetStringInfo("get_var $vdjVideoSyncAddr", buf, sizeof(buf)) == S_OK && buf[0]) {
-        if (isValidHost(buf) && strcmp(paramIP_, buf) != 0) {
-            strncpy(paramIP_, buf, kParamSize);
-            paramIP_[kParamSize - 1] = '\0';
-            changed = true;
-        }
-    }
-
-    memset(buf, 0, sizeof(buf));
-    if (GetStringInfo("get_var $vdjVideoSyncPort", buf, sizeof(buf)) == S_OK && buf[0]) {
-        if (isValidPort(buf) && strcmp(paramPort_, buf) != 0) {
-            strncpy(paramPort_, buf, kParamSize);
-            paramPort_[kParamSize - 1] = '\0';
-            changed = true;
-        }
-    }
-
-    if (changed) recreateClient();
-}
-
-void CVideoSyncPlugin::settingsWatchLoop() {
-    while (watcherRunning_.load()) {
-        applyVarChanges();
-        std::this_thread::sleep_for(std::chrono::milliseconds(200));
-    }
+    // Read VDJ persistent vars and publish a new snapshot if the user
+    // changed them via set_var_dialog (which is non-blocking).  Runs on
+    // the scheduler and on VDJ's UI thread after a dialog; varsMu_ only
+    // orders the writers, readers never take it.
+    std::lock_guard<std::mutex> lock(varsMu_);
+    PluginConfig next = *config();
+
+    // Reads one var into field if it is valid and differs.  size is the
+    // field's parameter buffer, so values are cut as before.
+    char buf[kEndpointsParamSize] = {};
+    auto read = [&](const char* query, int size, bool (*valid)(const char*), std::string& field) {
+        if (!vdjString(query, buf, size) || !buf[0]) return false;
+        if (!valid(buf) || field == buf) return false;
+        field = buf;
+        return true;
+    };
+    bool endpoint  = read("get_var $vdjVideoSyncAddr", kParamSize, isValidHost, next.ip);
+    endpoint       = read("get_var $vdjVideoSyncPort", kParamSize, isValidPort, next.port) || endpoint;
+    endpoint       = read("get_var $vdjVideoSyncTransport", kParamSize, isValidTransport, next.transport) || endpoint;
+    bool deadbands = read("get_var $vdjVideoSyncDeadbands", kParamSize, isValidDeadbands, next.deadbands);
+    bool pollRates = read("get_var $vdjVideoSyncPollRates", kParamSize, isValidPollRates, next.pollRates);
+    bool endpoints = read("get_var $vdjVideoSyncEndpoints", kEndpointsParamSize, isValidEndpoints, next.endpoints);
+    if (!(endpoint || deadbands || pollRates || endpoints)) return;
+
+    publishConfig(next);
+    if (endpoint)  updateEndpoint();
+    if (deadbands) applyDeadbands();
+    if (pollRates) applyPollRates();
+    if (endpoints) applyEndpoints();
 }
 
 HRESULT VDJ_API CVideoSyncPlugin::OnGetPluginInfo(TVdjPluginInfo8* info) {
@@ -235,19 +657,18 @@ HRESULT VDJ_API CVideoSyncPlugin::OnGetPluginInfo(TVdjPluginInfo8* info) {
 }
 
 ULONG VDJ_API CVideoSyncPlugin::Release() {
-    // Stop the worker thread if still running
-    stopWorker();
-
-    // Stop the settings watcher
-    watcherRunning_ = false;
-    if (settingsWatcher_.joinable()) settingsWatcher_.join();
-
-    // Destroy the HTTP client
+    // Hand the engine to another instance, if any: once unregistered this
+    // one is retired by the rebalance, or by one already under way.
     {
-        std::lock_guard<std::mutex> lock(httpMutex_);
-        delete httpClient_;
-        httpClient_ = nullptr;
+        EngineRegistry& registry = engineRegistry();
+        std::lock_guard<std::mutex> lock(registry.mu);
+        auto& instances = registry.instances;
+        for (auto it = instances.begin(); it != instances.end(); ++it) {
+            if (*it == this) { instances.erase(it); break; }
+        }
+        enabled_ = false;
     }
+    rebalanceEngine();
 
     delete this;
     return 0;
@@ -258,18 +679,31 @@ ULONG VDJ_API CVideoSyncPlugin::Release() {
 HRESULT VDJ_API CVideoSyncPlugin::OnStart() {
     // Pick up any variable changes made while the effect was disabled
     applyVarChanges();
-    startWorker();
+    EngineRegistry& registry = engineRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mu);
+        enabled_ = true;
+    }
+    rebalanceEngine();
     return S_OK;
 }
 
 HRESULT VDJ_API CVideoSyncPlugin::OnStop() {
-    // Effect toggled OFF in VirtualDJ – stop sending data
-    stopWorker();
+    // Effect toggled OFF in VirtualDJ – data keeps flowing while another
+    // instance is still enabled
+    EngineRegistry& registry = engineRegistry();
+    {
+        std::lock_guard<std::mutex> lock(registry.mu);
+        enabled_ = false;
+    }
+    rebalanceEngine();
     return S_OK;
 }
 
-HRESULT VDJ_API CVideoSyncPlugin::OnProcessSamples(float* /*buffer*/, int /*nb*/) {
-    // We don't modify audio – pass-through
+HRESULT VDJ_API CVideoSyncPlugin::OnProcessSamples(float* /*buffer*/, int nb) {
+    // We don't modify audio – pass-through.  The block only advances the
+    // sample clock the poll tick is timed from.
+    audioClock_.onBlock(nb, SampleRate);
     return S_OK;
 }
 
@@ -278,145 +712,1005 @@ HRESULT VDJ_API CVideoSyncPlugin::OnProcessSamples(float* /*buffer*/, int /*nb*/
 void CVideoSyncPlugin::startWorker() {
     if (running_.load()) return;
     running_ = true;
-    worker_ = std::thread(&CVideoSyncPlugin::pollLoop, this);
+    Engine& engine = *engine_;
+    for (auto& endpoint : engine.fanout) endpoint.start();
+    engine.link.resume();
+    senderExited_ = false;
+    sender_ = std::thread(&CVideoSyncPlugin::sendLoop, this);
+    burstUntilUs_ = 0;
+    nextDeckProbeUs_ = 0;  // re-probe the layout on the first tick
+    deckProbeFailed_ = false;
+    setPollMode(PollNominal);
+    engine.scheduler.enable(engine.pollTask);
+    engine.scheduler.enable(engine.statsTask,
+                            Scheduler::clock::now() + std::chrono::milliseconds(kStatsIntervalMs));
 }
 
 void CVideoSyncPlugin::stopWorker() {
+    // disable() waits out a tick in progress, so nothing publishes after.
+    Engine& engine = *engine_;
+    engine.scheduler.disable(engine.pollTask);
+    engine.scheduler.disable(engine.statsTask);
     running_ = false;
-    if (worker_.joinable()) {
-        worker_.join();
+    wakeSender();
+    if (sender_.joinable()) {
+        // Abort whatever request the sender is in.  A request it starts
+        // just after one cancel() is caught by the next, so this returns
+        // within a slice of the sender's current step.
+        while (!senderExited_.load()) {
+            engine.link.cancel();
+            std::this_thread::sleep_for(std::chrono::milliseconds(kCancelRetryMs));
+        }
+        sender_.join();
     }
+    for (auto& endpoint : engine.fanout) endpoint.stop();
 }
 
+// Builds this instance's engine on election: the link and endpoints,
+// pointed at the current settings, and the scheduler with the settings
+// watch running.  Poll, settings watch and stats heartbeat share its one
+// thread.  The settings watch is always on (VDJ vars can change even
+// while the effect is disabled); the others run with the worker.  Only
+// the poll is time-critical; the others have slack to run in its
+// wakeups.
+void CVideoSyncPlugin::hostEngine() {
+    std::lock_guard<std::mutex> lock(varsMu_);
+    engine_ = std::make_unique<Engine>();
+    Engine& engine = *engine_;
+    // Before any thread can see them: the poll tick reads the fan-out
+    // frames without a lock, and endpoints may be enabled at any time.
+    for (auto& frame : engine.fanoutFrames) {
+        frame = std::make_shared<std::string>();
+        frame->reserve(kMaxFrameBytes);
+    }
+    engine.pollTask = engine.scheduler.add("poll", pollNominalMs_.load(), 0, [this] { pollTick(); },
+        [this](Scheduler::clock::time_point next) {
+            // While audio runs, land just after the block boundary so the
+            // read sees a freshly processed block.
+            return pollAudio_ ? audioClock_.nextBlockAfter(next) : next;
+        });
+    engine.settingsTask = engine.scheduler.add("settings", kSettingsIntervalMs, kTaskSlackMs,
+                                               [this] { applyVarChanges(); });
+    engine.statsTask = engine.scheduler.add("stats", kStatsIntervalMs, kTaskSlackMs, [this] {
+        statsDue_ = true;
+        wakeSender();
+    });
+
+    updateEndpoint();
+    applyEndpoints();
+    engine.link.onControl = [this](const std::string& msg) { handleControl(msg); };
+    pollPeriodMs_ = 0;  // the new scheduler runs the poll at nominal
+    engine.scheduler.enable(engine.settingsTask);
+    engine.scheduler.start();
+}
 
+// Stops every engine thread, then drops the engine.  The scheduler is
+// stopped before varsMu_ is taken: its settings task takes it too.
+void CVideoSyncPlugin::retireEngine() {
+    if (!engine_) return;
+    stopWorker();
+    engine_->scheduler.stop();
+    std::unique_ptr<Engine> engine;
+    {
+        std::lock_guard<std::mutex> lock(varsMu_);
+        engine = std::move(engine_);
+    }
+}
+
+// Moves the engine to the instance that should host it and starts or
+// stops the worker to match whether any instance is enabled.  Prefers
+// an enabled host, whose OnProcessSamples() drives the audio clock.  A
+// new host starts from scratch: fresh link, snapshots for every deck.
+// The host is picked under the registry mutex; the old engine is torn
+// down and the new one started after it is released, under handover
+// only, so no registry lookup ever waits for a thread join.  Call
+// without either mutex held.
+void CVideoSyncPlugin::rebalanceEngine() {
+    EngineRegistry& registry = engineRegistry();
+    std::lock_guard<std::mutex> handover(registry.handover);
+
+    CVideoSyncPlugin* retired = nullptr;
+    CVideoSyncPlugin* host = nullptr;
+    bool enabled = false;
+    {
+        std::lock_guard<std::mutex> lock(registry.mu);
+        for (CVideoSyncPlugin* instance : registry.instances) {
+            if (instance->enabled_) { host = instance; break; }
+        }
+        enabled = host != nullptr;
+        if (!host && !registry.instances.empty()) host = registry.instances.front();
+        int count = 0;
+        for (CVideoSyncPlugin* instance : registry.instances) count += instance->enabled_ ? 1 : 0;
+        registry.loaded  = static_cast<int>(registry.instances.size());
+        registry.enabled = count;
+
+        if (host != registry.host) {
+            retired = registry.host;
+            if (retired) registry.handovers++;
+            registry.host = host;
+        }
+    }
+
+    // Both stay registered (or, being released, alive) until handover
+    // is released: Release() rebalances before it deletes.
+    if (retired) retired->retireEngine();
+    if (!host) return;
+    if (!host->engine_) host->hostEngine();
+    if (enabled) host->startWorker();
+    else         host->stopWorker();
+}
+
+std::string CVideoSyncPlugin::engineStatsJson() {
+    const EngineRegistry& registry = engineRegistry();
+    std::ostringstream ss;
+    ss << "{"
+       << "\"instances\":" << registry.loaded.load() << ","
+       << "\"enabled\":" << registry.enabled.load() << ","
+       << "\"handovers\":" << registry.handovers.load()
+       << "}";
+    return ss.str();
+}
+
+void CVideoSyncPlugin::wakeSender() {
+    {
+        std::lock_guard<std::mutex> lock(sendMu_);
+        sendPending_ = true;
+    }
+    sendCv_.notify_one();
+}
 
 // ── Polling loop ────────────────────────────────────────
 
-void CVideoSyncPlugin::pollLoop() {
+void CVideoSyncPlugin::pollTick() {
     using clock = std::chrono::steady_clock;
-    while (running_.load()) {
-        auto start = clock::now();
-
-        // Check for VDJ var changes from set_var_dialog
-        applyVarChanges();
+    auto start = clock::now();
+    AllocCheck alloc("the poll tick");
+
+    // ── Phase 1: Read ALL deck states in a tight batch ──
+    // No network calls here – just VDJ API queries.
+    // This ensures elapsedMs values are comparable across decks
+    // (no HTTP round-trip drift between reads).  While audio runs,
+    // the batch is stamped with when the block it reflects is heard.
+    DeckState current[kMaxDecks];
+    pollAudio_ = audioClock_.update();
+    auto captureUs = pollAudio_ ? audioClock_.audibleUs()
+                                : std::chrono::duration_cast<std::chrono::microseconds>(
+                                      start.time_since_epoch()).count();
+    // Only the decks of the host's layout are read.
+    bool published = discoverDecks(captureUs);
+    int decks = deckCount_.load();
+    // One composite host call for every deck's numeric verbs when the
+    // host supports it, otherwise per-verb reads.
+    double values[kMaxDecks][DeckQueries::kNumeric];
+    double globals[DeckQueries::kGlobals] = {};
+    bool batched = queries_.batch(captureUs, values, globals);
+    for (int d = 0; d < decks; ++d) {
+        current[d] = readDeckState(d + 1, captureUs, batched ? values[d] : nullptr);
+        current[d].captureUs = captureUs;
+    }
 
-        // ── Phase 1: Read ALL deck states in a tight batch ──
-        // No network calls here – just VDJ API queries.
-        // This ensures elapsedMs values are comparable across decks
-        // (no HTTP round-trip drift between reads).
-        DeckState current[kMaxDecks];
-        for (int d = 0; d < kMaxDecks; ++d) {
-            current[d] = readDeckState(d + 1);
+    // ── Phase 2: Mark mirrored / duplicate decks ──
+    // VDJ master-bus effects see the mixed signal, so querying
+    // "deck 3 get_filename" may return deck 1's filename when
+    // deck 3 has nothing loaded.  We compare within the CURRENT
+    // batch so timing differences can't escape the filter.  Each
+    // deck is looked up by (filename, play, audible) in a small
+    // open-addressing table and then entered, so it is a mirror when
+    // a lower deck with the same key got there first: one probe per
+    // deck instead of a comparison with every other one.
+    bool skip[kMaxDecks] = {};
+    int8_t mirror[kMirrorSlots];
+    std::memset(mirror, -1, sizeof(mirror));
+    for (int d = 0; d < decks; ++d) {
+        const DeckState& s = current[d];
+        if (s.filename.empty()) { skip[d] = true; continue; }
+        uint32_t key = s.filename.hash() ^ (s.isPlaying ? 0x9E3779B9u : 0u) ^ (s.isAudible ? 0x85EBCA6Bu : 0u);
+        for (uint32_t i = key & (kMirrorSlots - 1);; i = (i + 1) & (kMirrorSlots - 1)) {
+            if (mirror[i] < 0) {
+                mirror[i] = static_cast<int8_t>(d);
+                break;
+            }
+            const DeckState& prev = current[mirror[i]];
+            if (prev.filename == s.filename && prev.isPlaying == s.isPlaying
+                && prev.isAudible == s.isAudible) {
+                skip[d] = true;
+                break;
+            }
         }
+    }
 
-        // ── Phase 2: Mark mirrored / duplicate decks ──
-        // VDJ master-bus effects see the mixed signal, so querying
-        // "deck 3 get_filename" may return deck 1's filename when
-        // deck 3 has nothing loaded.  We compare within the CURRENT
-        // batch so timing differences can't escape the filter.
-        bool skip[kMaxDecks] = {};
-        for (int d = 1; d < kMaxDecks; ++d) {
-            if (current[d].filename.empty()) { skip[d] = true; continue; }
-            for (int prev = 0; prev < d; ++prev) {
-                if (skip[prev] || current[prev].filename.empty()) continue;
-                if (current[d].filename == current[prev].filename
-                    && current[d].isPlaying == current[prev].isPlaying
-                    && current[d].isAudible == current[prev].isAudible) {
-                    skip[d] = true;
-                    break;
-                }
-            }
+    // Subscribed verbs for the server's overlays, on their own
+    // intervals; empty and mirrored decks read as no value.
+    bool loaded[kMaxDecks] = {};
+    for (int d = 0; d < decks; ++d) loaded[d] = !skip[d];
+    bool verbsChanged = verbs_.poll(captureUs, loaded);
+
+    // Mixer-wide state: whether anything plays, and the crossfader and
+    // master deck, which only matter then.  Free in a batch, one call
+    // each otherwise.
+    bool active = false;
+    for (int d = 0; d < decks; ++d) {
+        active = active || (loaded[d] && (current[d].isPlaying || current[d].isAudible));
+    }
+    if (active && !batched) {
+        if (!queries_.global(DeckQueries::Crossfader, globals[DeckQueries::Crossfader])) {
+            globals[DeckQueries::Crossfader] = tickCrossfader_;  // unknown: not moved
         }
+        queries_.global(DeckQueries::ActiveDeck, globals[DeckQueries::ActiveDeck]);
+    }
 
-        // ── Phase 3: Send updates for non-duplicate, changed decks ──
-        for (int d = 0; d < kMaxDecks; ++d) {
-            if (current[d].filename.empty()) continue;
-            if (skip[d]) continue;
-
-            // Send if something changed OR if the deck is playing (elapsedMs updates).
-            // For paused decks, detect seeks (large elapsedMs jumps) but ignore
-            // tiny VDJ clock jitter (1-2ms) that would cause unnecessary traffic.
-            if (current[d] != lastState_[d]
-                || current[d].isPlaying
-                || (!current[d].isPlaying
-                    && std::abs(current[d].elapsedMs - lastState_[d].elapsedMs) > 50)) {
-                lastState_[d] = current[d];
-                sendUpdate(current[d]);
+    // ── Phase 3: Hand non-duplicate, changed decks to the sender ──
+    // publish() never blocks: if the sender is still busy with the
+    // previous state for a deck, that state is replaced (coalesced).
+    // Continuous changes are held to each deck's share of the update
+    // budget (see allocateBudget()); discrete ones always go out.
+    // Along the way, note whether a fader, the pitch or the position
+    // just moved, for the poll rate.
+    double allowedHz[kMaxDecks];
+    allocateBudget(current, loaded, static_cast<int>(globals[DeckQueries::ActiveDeck]), allowedHz);
+    bool moving = false;
+    for (int d = 0; d < decks; ++d) {
+        if (!loaded[d]) continue;
+        bool sameTrack = current[d].filename == lastState_[d].filename;  // not a load
+        moving = moving || (sameTrack
+              && (std::fabs(current[d].volume - tickVolume_[d]) > deadbandVolume_.load()
+               || std::fabs(current[d].pitch - tickPitch_[d]) > deadbandPitch_.load()));
+        tickVolume_[d] = current[d].volume;
+        tickPitch_[d]  = current[d].pitch;
+
+        // Send on a discrete change, or when elapsedMs strays from
+        // where the last published state predicts it (a seek, a
+        // stall, clock drift).  Steady playback only sends a slow
+        // heartbeat; the server integrates position in between.
+        const DeckState& last = lastState_[d];
+        double sinceMs = (current[d].captureUs - last.captureUs) / 1000.0;
+        double predictedMs = last.elapsedMs;
+        if (last.isPlaying) predictedMs += sinceMs * last.pitch / 100.0;
+        bool drifted = std::fabs(current[d].elapsedMs - predictedMs)
+                       > positionToleranceMs_.load();
+        bool heartbeat = current[d].isPlaying && sinceMs >= kPositionHeartbeatMs;
+        moving = moving || (drifted && sameTrack);
+        bool discrete = !sameTrack
+                     || current[d].isPlaying != last.isPlaying
+                     || current[d].isAudible != last.isAudible;
+
+        if (current[d] != last || drifted || heartbeat) {
+            // An unsent change stays a difference against lastState_,
+            // so it goes out once the deck's interval has passed.
+            if (!discrete && sinceMs * allowedHz[d] < 1000.0) {
+                counters_.throttled++;
+                continue;
             }
+            lastState_[d] = current[d];
+            if (outbox_[d].publish(current[d])) counters_.coalesced++;
+            counters_.published++;
+            deckPublished_[d]++;
+            published = true;
+        } else if (current[d].isPlaying) {
+            counters_.predicted++;
         }
+    }
+    if (published || verbsChanged) wakeSender();
+    if (published) publishFanout();
+    alloc.check();
+
+    // ── Phase 4: Pick the rate of the next tick ──
+    double crossfader = globals[DeckQueries::Crossfader];
+    if (active) {
+        moving = moving || std::fabs(crossfader - tickCrossfader_) > deadbandVolume_.load();
+        tickCrossfader_ = crossfader;
+    }
+    if (moving && active) {
+        if (captureUs >= burstUntilUs_) bursts_++;
+        burstUntilUs_ = captureUs + pollHoldMs_.load() * 1000LL;
+    }
+    PollMode mode = captureUs < burstUntilUs_ ? PollBurst : active ? PollNominal : PollIdle;
+    pollTicks_[mode]++;
+    setPollMode(mode);
+}
 
-        // Sleep for the remainder of the poll interval
-        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-            clock::now() - start);
-        auto sleepMs = std::chrono::milliseconds(pollIntervalMs_) - elapsed;
-        if (sleepMs.count() > 0) {
-            std::this_thread::sleep_for(sleepMs);
+// Splits the update budget, kBudgetDecks full-rate decks' worth, across
+// the loaded decks by importance: being audible, the fader, being VDJ's
+// master deck, and above all being the deck whose video the server has
+// on screen.  A deck's share is capped at the poll rate (no throttling)
+// and floored at kMinDeckHz, so a deck cueing in the headphones still
+// updates, just rarely.
+void CVideoSyncPlugin::allocateBudget(const DeckState* current, const bool* loaded,
+                                      int masterDeck, double* allowedHz) {
+    // Before the first setPollMode() the scheduler runs the nominal rate.
+    int periodMs = pollPeriodMs_ > 0 ? pollPeriodMs_ : pollNominalMs_.load();
+    double pollHz = 1000.0 / periodMs;
+    double weight[kMaxDecks] = {};
+    double total = 0.0;
+    int videoDeck = videoDeck_.load();
+    int decks = deckCount_.load();
+    for (int d = 0; d < decks; ++d) {
+        if (!loaded[d]) continue;
+        const DeckState& s = current[d];
+        weight[d] = 0.05;
+        if (s.isAudible)           weight[d] += 0.4 + 0.25 * s.volume;
+        if (d + 1 == masterDeck)   weight[d] += 0.3;
+        if (d + 1 == videoDeck)    weight[d] += 1.0;
+        total += weight[d];
+    }
+    for (int d = 0; d < decks; ++d) {
+        double hz = total > 0.0 ? pollHz * kBudgetDecks * weight[d] / total : pollHz;
+        allowedHz[d] = std::max(kMinDeckHz, std::min(pollHz, hz));
+        deckWeight_[d]    = weight[d];
+        deckAllowedHz_[d] = loaded[d] ? allowedHz[d] : 0.0;
+    }
+}
+
+// Follows the host's deck layout: decks 1..n answer deck verbs.  A
+// recheck costs two calls (is deck n still there, has n+1 appeared);
+// only the first probe walks every deck.  A deck that goes away is
+// published once as empty, so the server drops its last state before
+// it stops accepting that deck.  True if it published.
+bool CVideoSyncPlugin::discoverDecks(int64_t nowUs) {
+    if (deckProbeFailed_ || nowUs < nextDeckProbeUs_) return false;
+    nextDeckProbeUs_ = nowUs + kDeckProbeMs * 1000LL;
+
+    int old = deckCount_.load();
+    int n = old;
+    while (n < kMaxDecks && queries_.exists(n + 1)) ++n;
+    if (n == old) {
+        while (n > 0 && !queries_.exists(n)) --n;
+    }
+    if (n < 2) {
+        // No usable answer: assume the usual layout.  Walking such a host
+        // again would cost kDefaultDecks + 1 calls per recheck for the
+        // same answer, so it is left alone until the worker restarts.
+        n = kDefaultDecks;
+        deckProbeFailed_ = true;
+    }
+    if (n == old) return false;
+
+    bool published = false;
+    for (int d = n; d < old; ++d) {
+        DeckState gone;
+        gone.deck = d + 1;
+        gone.captureUs = nowUs;
+        lastState_[d] = gone;
+        deckCache_[d] = DeckCache{};
+        if (outbox_[d].publish(gone)) counters_.coalesced++;
+        counters_.published++;
+        published = true;
+    }
+    queries_.compile(n);
+    deckCount_ = n;
+    return published;
+}
+
+std::string CVideoSyncPlugin::pollStatsJson() const {
+    static const char* const names[kPollModes] = {"idle", "nominal", "burst"};
+    std::ostringstream ss;
+    ss << "{\"mode\":\"" << names[pollMode_.load()] << "\",\"ticks\":{";
+    for (int m = 0; m < kPollModes; ++m) {
+        if (m > 0) ss << ',';
+        ss << '"' << names[m] << "\":" << pollTicks_[m].load();
+    }
+    ss << "},\"bursts\":" << bursts_.load() << "}";
+    return ss.str();
+}
+
+// Per-deck weight, allowed and actual update rate.  secs is the time
+// since the last report (0 for the first, which has no rate yet).
+std::string CVideoSyncPlugin::budgetStatsJson(double secs) {
+    std::ostringstream ss;
+    ss << "{\"videoDeck\":" << videoDeck_.load() << ",\"decks\":[";
+    ss.precision(3);
+    int decks = deckCount_.load();
+    for (int d = 0; d < kMaxDecks; ++d) {
+        uint64_t published = deckPublished_[d].load();
+        double sentHz = secs > 0 ? (published - statsPublished_[d]) / secs : 0.0;
+        statsPublished_[d] = published;
+        if (d >= decks) continue;
+        if (d > 0) ss << ',';
+        ss << "{\"deck\":" << d + 1
+           << ",\"weight\":" << deckWeight_[d].load()
+           << ",\"allowedHz\":" << deckAllowedHz_[d].load()
+           << ",\"sentHz\":" << sentHz << '}';
+    }
+    ss << "]}";
+    return ss.str();
+}
+
+// Runs the poll at the mode's interval.  From the poll tick the new
+// period applies from the next deadline.
+void CVideoSyncPlugin::setPollMode(PollMode mode) {
+    int periodMs = mode == PollBurst ? pollBurstMs_.load()
+                 : mode == PollIdle  ? pollIdleMs_.load()
+                                     : pollNominalMs_.load();
+    pollMode_ = mode;
+    if (periodMs == pollPeriodMs_) return;
+    pollPeriodMs_ = periodMs;
+    engine_->scheduler.setPeriod(engine_->pollTask, periodMs);
+}
+
+// Encodes the last published state of every deck once and shares the
+// frame with all enabled endpoints.  Runs on the poll tick; the
+// endpoints only ever receive a pointer.  The frame is one of the
+// engine's preallocated buffers that no mailbox holds any more, so
+// nothing is allocated.
+void CVideoSyncPlugin::publishFanout() {
+    Engine& engine = *engine_;
+    bool any = false;
+    for (const auto& endpoint : engine.fanout) any = any || endpoint.enabled();
+    if (!any) return;
+
+    const std::shared_ptr<std::string>* spare = nullptr;
+    for (const auto& buffer : engine.fanoutFrames) {
+        if (buffer.use_count() == 1) {
+            spare = &buffer;
+            break;
         }
     }
+    if (!spare) return;  // cannot happen, see kFanoutFrames
+    // Order the reuse after the sender threads' last reads of it.
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    std::string* frame = spare->get();
+    frame->clear();
+    *frame += "{\"decks\":[";
+    bool first = true;
+    for (const DeckState& state : lastState_) {
+        if (state.deck == 0) continue;  // never published
+        if (!first) *frame += ',';
+        state.appendJson(*frame);
+        first = false;
+    }
+    *frame += "]}";
+
+    FanoutEndpoint::Frame shared = *spare;
+    int decks = deckCount_.load();
+    for (auto& endpoint : engine.fanout) endpoint.publish(shared, decks);
 }
 
-DeckState CVideoSyncPlugin::readDeckState(int deck) {
+// Counted wrapper around GetStringInfo(), for the vdjCalls stats.  Deck
+// reads go through queries_, which counts the same way.
+bool CVideoSyncPlugin::vdjString(const char* query, char* buf, int size) {
+    counters_.vdjCalls++;
+    std::memset(buf, 0, size);
+    return GetStringInfo(query, buf, size) == S_OK;
+}
+
+// Reads one deck in tiers.  Cold metadata (filename, title, artist) is
+// cached per loaded track and only re-read when get_songlength, a cheap
+// numeric read, changes or every kMetaRecheckMs (a load with the same
+// length).  BPM is re-read when the pitch moves, on load and on the
+// recheck.  The hot fields are read every tick, but not at all while
+// the deck is empty.  batch, when given, holds this tick's numeric
+// verbs from the composite query and replaces the per-verb reads.
+DeckState CVideoSyncPlugin::readDeckState(int deck, int64_t nowUs, const double* batch) {
+    using Q = DeckQueries;
     DeckState s;
     s.deck = deck;
+    DeckCache& cache = deckCache_[deck - 1];
 
-    // Build deck-prefixed query strings
-    char query[128];
-    char buf[512];
+    char buf[DeckText::kCapacity + 1];
     double val = 0.0;
+    auto number = [&](Q::Verb verb, double& out) {
+        if (batch) { out = batch[verb]; return true; }
+        return queries_.number(deck, verb, out);
+    };
+
+    // get_songlength (float, seconds): the track-change signal
+    // NOTE: get_totaltime_ms returns the centiseconds *component* (0-99),
+    //       NOT total time in ms.  get_songlength returns total seconds.
+    double lengthSec = 0.0;
+    if (number(Q::Length, val)) lengthSec = val;
+
+    bool recheck = nowUs - cache.checkedUs >= kMetaRecheckMs * 1000;
+    bool loaded = false;
+    if (lengthSec != cache.lengthSec || recheck) {
+        // get_filename (string)
+        DeckText filename;
+        if (queries_.text(deck, Q::Filename, buf, sizeof(buf))) filename.assign(buf);
+
+        loaded = filename != cache.filename || lengthSec != cache.lengthSec;
+        if (loaded) {
+            cache.title.clear();
+            cache.artist.clear();
+            if (!filename.empty()) {
+                // get_title / get_artist (string, song metadata)
+                if (queries_.text(deck, Q::Title, buf, sizeof(buf))) cache.title.assign(buf);
+                if (queries_.text(deck, Q::Artist, buf, sizeof(buf))) cache.artist.assign(buf);
+            }
+            cache.filename = filename;
+            cache.lengthSec = lengthSec;
+        }
+        cache.checkedUs = nowUs;
+    }
+    s.filename    = cache.filename;
+    s.title       = cache.title;
+    s.artist      = cache.artist;
+    s.totalTimeMs = static_cast<int>(cache.lengthSec * 1000.0);
+    if (s.filename.empty()) return s;
 
     // is_audible (bool)
-    std::snprintf(query, sizeof(query), "deck %d is_audible", deck);
-    if (GetInfo(query, &val) == S_OK) s.isAudible = (val != 0.0);
+    if (number(Q::Audible, val)) s.isAudible = (val != 0.0);
 
     // play (bool)
-    std::snprintf(query, sizeof(query), "deck %d play", deck);
-    if (GetInfo(query, &val) == S_OK) s.isPlaying = (val != 0.0);
+    if (number(Q::Play, val)) s.isPlaying = (val != 0.0);
 
     // get_volume (float 0.0-1.0)
-    std::snprintf(query, sizeof(query), "deck %d get_volume", deck);
-    if (GetInfo(query, &val) == S_OK) s.volume = val;
+    if (number(Q::Volume, val)) s.volume = val;
 
     // get_time elapsed absolute (int, ms)
-    std::snprintf(query, sizeof(query), "deck %d get_time elapsed absolute", deck);
-    if (GetInfo(query, &val) == S_OK) s.elapsedMs = static_cast<int>(val);
+    if (number(Q::Time, val)) s.elapsedMs = static_cast<int>(val);
 
-    // get_bpm (float)
-    std::snprintf(query, sizeof(query), "deck %d get_bpm", deck);
-    if (GetInfo(query, &val) == S_OK) s.bpm = val;
+    // get_pitch_value (float, centered on 100%)
+    if (number(Q::Pitch, val)) s.pitch = val;
 
-    // get_filename (string)
-    std::snprintf(query, sizeof(query), "deck %d get_filename", deck);
-    if (GetStringInfo(query, buf, sizeof(buf)) == S_OK) s.filename = buf;
+    // get_bpm (float): follows the pitch; analysis may also revise it
+    // shortly after a load, which the recheck picks up.  Free in a batch.
+    if (batch || loaded || recheck || s.pitch != cache.pitch) {
+        if (number(Q::Bpm, val)) cache.bpm = val;
+        cache.pitch = s.pitch;
+    }
+    s.bpm = cache.bpm;
 
-    // get_pitch_value (float, centered on 100%)
-    std::snprintf(query, sizeof(query), "deck %d get_pitch_value", deck);
-    if (GetInfo(query, &val) == S_OK) s.pitch = val;
+    return s;
+}
 
-    // get_songlength (float, seconds) → convert to ms
-    // NOTE: get_totaltime_ms returns the centiseconds *component* (0-99),
-    //       NOT total time in ms.  get_songlength returns total seconds.
-    std::snprintf(query, sizeof(query), "deck %d get_songlength", deck);
-    if (GetInfo(query, &val) == S_OK) s.totalTimeMs = static_cast<int>(val * 1000.0);
+// ── Sender loop ─────────────────────────────────────────
+// Drains the newest state per deck and posts them as one batch.  Blocking
+// HTTP calls happen only here, so a slow or dead server never delays
+// pollTick().
 
-    // get_title (string, song title metadata)
-    memset(buf, 0, sizeof(buf));
-    std::snprintf(query, sizeof(query), "deck %d get_title", deck);
-    if (GetStringInfo(query, buf, sizeof(buf)) == S_OK) s.title = buf;
+void CVideoSyncPlugin::sendLoop() {
+    ServerLink& link = engine_->link;
+    using clock = std::chrono::steady_clock;
+    auto nextRefresh = clock::now();
 
-    // get_artist (string, song artist metadata)
-    memset(buf, 0, sizeof(buf));
-    std::snprintf(query, sizeof(query), "deck %d get_artist", deck);
-    if (GetStringInfo(query, buf, sizeof(buf)) == S_OK) s.artist = buf;
+    // A new session tells the server to restart sequence tracking.
+    datagramSession_ = std::random_device{}();
+    datagramSeq_ = 0;
+    auto nextClock = clock::now();
+    clockT0_ = clockT3_ = 0;
+    clockExchanges_ = 0;
 
-    return s;
+    // Room for the largest frame, so encoding never grows the buffer.
+    frame_.reserve(kMaxFrameBytes);
+
+    // Forget what the server was sent: every deck starts with a snapshot.
+    for (int d = 0; d < kMaxDecks; ++d) sentTrack_[d] = 0;
+    resyncPending_ = false;
+
+    while (running_.load()) {
+        // While the link is down, states stay in the outbox (coalescing to
+        // the newest) and we only wake for the next reconnect attempt.
+        bool up = link.isUp();
+        auto wakeAt = up ? clock::now() + std::chrono::milliseconds(kStatsIntervalMs)
+                         : link.retryAt();
+        if (up && link.datagramOpen() && nextRefresh < wakeAt) wakeAt = nextRefresh;
+        if (up && resyncPending_) {
+            // A failed delivery: retry even if no deck changes meanwhile
+            auto retry = clock::now() + std::chrono::milliseconds(kResendRetryMs);
+            if (retry < wakeAt) wakeAt = retry;
+        }
+        if (up && clockSupported_ && nextClock < wakeAt) wakeAt = nextClock;
+        {
+            std::unique_lock<std::mutex> lock(sendMu_);
+            sendCv_.wait_until(lock, wakeAt, [this, up] {
+                return (sendPending_ && up) || !running_.load();
+            });
+            sendPending_ = false;
+        }
+        if (!running_.load()) break;
+        if (!link.ensureConnected()) continue;
+
+        // A new connection may mean a restarted server or frames lost
+        // with the old one: resend every deck in full.
+        if (link.epoch() != linkEpoch_) {
+            linkEpoch_ = link.epoch();
+            requestResync();
+            clockSupported_ = true;
+            subsStale_ = subsSupported_ = true;
+            verbs_.resendAll();
+            decksReported_ = 0;  // a restarted server assumes the default layout
+        }
+        link.pollControl();
+
+        // The server accepts decks up to the count in the stats: report
+        // more decks before the frames that need them, fewer after the
+        // frames that empty the decks that went away.
+        int decks = deckCount_.load();
+        if (decks > decksReported_) sendStats();
+
+        const DeckState* batch[kMaxDecks];
+        int count = 0;
+        bool taken[kMaxDecks] = {};
+        for (int d = 0; d < kMaxDecks; ++d) {
+            if (const DeckState* state = outbox_[d].take()) {
+                batch[count++] = state;
+                taken[d] = true;
+            }
+        }
+        if (resyncPending_) {
+            resyncPending_ = false;
+            for (int d = 0; d < kMaxDecks; ++d) {
+                const DeckState* state = outbox_[d].last();
+                if (state && !taken[d]) batch[count++] = state;
+            }
+        }
+
+        // Over UDP (or the shared-memory ring) every datagram carries all
+        // decks, including those that did not change, so it goes out on a
+        // change and, while idle, on the refresh interval to repair a lost
+        // final state.  A datagram that cannot be sent goes over HTTP
+        // instead, every deck it carried included.
+        if (link.datagramOpen() && (count > 0 || clock::now() >= nextRefresh)) {
+            nextRefresh = clock::now() + std::chrono::milliseconds(kDatagramRefreshMs);
+            if (sendDatagram()) {
+                counters_.sent += count;
+                count = 0;
+            } else {
+                for (int d = 0; d < kMaxDecks; ++d) {
+                    const DeckState* state = outbox_[d].last();
+                    if (state && !taken[d]) batch[count++] = state;
+                }
+            }
+        }
+
+        if (count > 0) {
+            int delivered = sendBatch(batch, count);
+            counters_.sent    += delivered;
+            counters_.dropped += count - delivered;
+        }
+
+        // Subscribed verbs ride behind the deck frames.
+        if (subsStale_ && subsSupported_) fetchSubscriptions();
+        sendVerbs();
+
+        // Deck frames go first; the clock exchange only runs when they
+        // are out, so it never delays one.
+        if (clockSupported_ && clock::now() >= nextClock) {
+            syncClock();
+            nextClock = clock::now() + std::chrono::milliseconds(
+                clockExchanges_ < kClockBurst ? kClockBurstMs : kClockIntervalMs);
+        }
+
+        if (statsDue_.exchange(false)) {
+            link.heartbeat();
+            sendStats();
+        } else if (decks != decksReported_) {
+            sendStats();
+        }
+    }
+    senderExited_ = true;
+}
+
+// One NTP-style exchange with the server: t0 and t3 bracket the request
+// on the steady clock that stamps captureUs, and travel with the next
+// request so the server can pair them with its own receive/reply times
+// and estimate offset and drift (server/internal/clocksync).
+void CVideoSyncPlugin::syncClock() {
+    ServerLink& link = engine_->link;
+    using clock = std::chrono::steady_clock;
+    auto nowUs = [] {
+        return static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(
+            clock::now().time_since_epoch()).count());
+    };
+
+    char path[128];
+    long long t0 = nowUs();
+    std::snprintf(path, sizeof(path), "/api/clock?t0=%lld&pt0=%lld&pt3=%lld",
+                  t0, static_cast<long long>(clockT0_), static_cast<long long>(clockT3_));
+    int status = link.get(path);
+    long long t3 = nowUs();
+
+    if (status == 404) {
+        clockSupported_ = false;  // older server; retried after a reconnect
+        clockT0_ = clockT3_ = 0;
+        return;
+    }
+    if (status < 200 || status >= 300) {
+        clockT0_ = clockT3_ = 0;  // nothing for the server to pair
+        return;
+    }
+    clockT0_ = t0;
+    clockT3_ = t3;
+    clockExchanges_++;
+    counters_.clockSyncs++;
+}
+
+// Encodes one frame of deck records into frame_, as JSON
+//   {"seq":N,"session":S,"captureUs":T,"decks":[...]}  (seq and session only when seq > 0)
+// or in the binary format above.  captureUs is the poll tick the newest
+// state came from.
+void CVideoSyncPlugin::encodeFrame(const DeckRecord* records, int count,
+                                   bool binary, uint64_t seq) {
+    int64_t captureUs = 0;
+    AllocCheck alloc("the frame encode");
+    for (int i = 0; i < count; ++i) {
+        if (records[i].state->captureUs > captureUs) captureUs = records[i].state->captureUs;
+    }
+
+    frame_.clear();
+    if (binary) {
+        putRaw(frame_, kWireVersion);
+        putRaw(frame_, static_cast<uint8_t>(count));
+        putRaw(frame_, static_cast<uint16_t>(0));
+        putRaw(frame_, seq > 0 ? datagramSession_ : uint32_t{0});
+        putRaw(frame_, seq);
+        putRaw(frame_, captureUs);
+        for (int i = 0; i < count; ++i) {
+            records[i].state->appendBinary(frame_, records[i].fields, records[i].track);
+        }
+        alloc.check();
+        return;
+    }
+
+    frame_ += '{';
+    if (seq > 0) {
+        frame_ += "\"seq\":";
+        appendInt(frame_, static_cast<long long>(seq));
+        frame_ += ",\"session\":";
+        appendInt(frame_, datagramSession_);
+        frame_ += ',';
+    }
+    frame_ += "\"captureUs\":";
+    appendInt(frame_, captureUs);
+    frame_ += ",\"decks\":[";
+    for (int i = 0; i < count; ++i) {
+        if (i > 0) frame_ += ',';
+        records[i].state->appendJson(frame_, records[i].fields, records[i].track);
+    }
+    frame_ += "]}";
+    alloc.check();
 }
 
-void CVideoSyncPlugin::sendUpdate(const DeckState& state) {
-    std::lock_guard<std::mutex> lock(httpMutex_);
-    if (!httpClient_) return;
+// Builds the record for state: a snapshot on track load, when asked or
+// when the server may have lost our view of the deck, otherwise a delta
+// of the fields that moved past their deadband.  Updates sentState_ to
+// what the server will hold once it is delivered.  Returns false when
+// nothing changed at all.
+bool CVideoSyncPlugin::makeRecord(const DeckState& state, bool snapshot, DeckRecord& out) {
+    int d = state.deck - 1;
+    DeckState& sent = sentState_[d];
+
+    if (sentTrack_[d] == 0 || state.filename != sent.filename
+        || state.title != sent.title || state.artist != sent.artist) {
+        sentTrack_[d] = nextTrack_++;
+        if (nextTrack_ == 0) nextTrack_ = 1;  // 0 means "no track"
+        snapshot = true;
+    }
+    if (needSnapshot_[d]) snapshot = true;
+
+    out.state = &state;
+    out.track = sentTrack_[d];
+    if (snapshot) {
+        out.fields = FIELD_ALL;
+        sent = state;
+        needSnapshot_[d] = false;
+        counters_.snapshots++;
+        return true;
+    }
 
-    std::string body = state.toJson();
-    auto result = httpClient_->Post("/api/deck/update", body, "application/json");
+    // Deadbands filter VDJ noise; a deadband of 0 resends any change.
+    auto moved = [](double now, double before, double deadband) {
+        return std::fabs(now - before) > deadband;
+    };
+    uint16_t fields = 0;
+    if (state.elapsedMs != sent.elapsedMs)                         fields |= FIELD_ELAPSED;
+    if (state.totalTimeMs != sent.totalTimeMs)                     fields |= FIELD_TOTAL_TIME;
+    if (moved(state.volume, sent.volume, deadbandVolume_.load()))  fields |= FIELD_VOLUME;
+    if (moved(state.bpm, sent.bpm, deadbandBpm_.load()))           fields |= FIELD_BPM;
+    if (moved(state.pitch, sent.pitch, deadbandPitch_.load()))     fields |= FIELD_PITCH;
+
+    if (fields == 0 && state.isAudible == sent.isAudible && state.isPlaying == sent.isPlaying) {
+        return false;
+    }
+
+    out.fields = fields;
+    sent.isAudible = state.isAudible;
+    sent.isPlaying = state.isPlaying;
+    if (fields & FIELD_ELAPSED)    sent.elapsedMs   = state.elapsedMs;
+    if (fields & FIELD_TOTAL_TIME) sent.totalTimeMs = state.totalTimeMs;
+    if (fields & FIELD_VOLUME)     sent.volume      = state.volume;
+    if (fields & FIELD_BPM)        sent.bpm         = state.bpm;
+    if (fields & FIELD_PITCH)      sent.pitch       = state.pitch;
+    counters_.deltas++;
+    return true;
+}
 
-    (void)result; // fire-and-forget
+// Marks every deck for a snapshot and makes the sender resend the last
+// state of each, including paused decks that publish nothing new.
+void CVideoSyncPlugin::requestResync() {
+    for (int d = 0; d < kMaxDecks; ++d) needSnapshot_[d] = true;
+    if (!resyncPending_) counters_.resyncs++;
+    resyncPending_ = true;
+    wakeSender();
+}
+
+// Control messages from the server: a WebSocket push or the body of a
+// /api/deck/batch or /api/plugin/stats response, e.g. {"type":"resync"}.
+// A "status" reply carries both the subscription version and the deck
+// on screen.
+void CVideoSyncPlugin::handleControl(const std::string& msg) {
+    if (msg.find("\"type\":\"resync\"") != std::string::npos) requestResync();
+    bool status = msg.find("\"type\":\"status\"") != std::string::npos;
+    if (status || msg.find("\"type\":\"subscriptions\"") != std::string::npos) {
+        size_t pos = msg.find("\"version\":");
+        if (pos != std::string::npos
+            && std::strtoul(msg.c_str() + pos + 10, nullptr, 10) != verbs_.version()) {
+            subsStale_ = true;
+        }
+    }
+    if (status || msg.find("\"type\":\"video\"") != std::string::npos) {
+        size_t pos = msg.find("\"videoDeck\":");
+        if (pos != std::string::npos) {
+            long deck = std::strtol(msg.c_str() + pos + 12, nullptr, 10);
+            videoDeck_ = deck >= 1 && deck <= kMaxDecks ? static_cast<int>(deck) : 0;
+        }
+    }
+}
+
+// Sends all decks from one tick as a single frame so the server can
+// process them atomically: streamed over the WebSocket when it is open,
+// otherwise POSTed.  Falls back to per-deck updates for servers that
+// predate /api/deck/batch.  Returns the number of states delivered.
+int CVideoSyncPlugin::sendBatch(const DeckState* const* states, int count) {
+    ServerLink& link = engine_->link;
+    DeckRecord records[kMaxDecks];
+    int recordCount = 0;
+    if (link.batchSupported) {
+        for (int i = 0; i < count; ++i) {
+            if (makeRecord(*states[i], false, records[recordCount])) ++recordCount;
+        }
+        if (recordCount == 0) return count;  // nothing the server doesn't already have
+    }
+
+    bool binary = link.binarySupported;
+    if (recordCount > 0) {
+        encodeFrame(records, recordCount, binary, 0);
+
+        // One-way: no reply to wait for before the next frame
+        if (link.streamOpen() && link.stream(frame_, binary)) return count;
+
+        counters_.requests++;
+        std::string response;
+        int status = link.post("/api/deck/batch", frame_,
+                                binary ? kDeckBinaryType : "application/json", &response);
+        if (binary && status == 415) {
+            // The server dropped binary support: this frame and the next as JSON
+            link.binarySupported = false;
+            encodeFrame(records, recordCount, false, 0);
+            counters_.requests++;
+            status = link.post("/api/deck/batch", frame_, "application/json", &response);
+        }
+        if (status >= 200 && status < 300) {
+            if (!response.empty()) handleControl(response);
+            return count;
+        }
+
+        // The server never saw these records: resend them in full, on
+        // the retry timer if their decks publish nothing new.
+        for (int i = 0; i < recordCount; ++i) needSnapshot_[records[i].state->deck - 1] = true;
+        if (status != 404 && status != 405) {
+            resyncPending_ = true;
+            return 0;
+        }
+        link.batchSupported = false;
+    }
+
+    int delivered = 0;
+    for (int i = 0; i < count; ++i) {
+        if (sendUpdate(*states[i])) ++delivered;
+    }
+    return delivered;
+}
+
+// Sends the current state of every deck as one datagram.  Datagrams may
+// be lost, so each carries full snapshots.  seq increases by one per
+// datagram so the server can drop stale ones and count gaps.
+bool CVideoSyncPlugin::sendDatagram() {
+    ServerLink& link = engine_->link;
+    DeckRecord records[kMaxDecks];
+    int count = 0;
+    for (int d = 0; d < kMaxDecks; ++d) {
+        if (const DeckState* state = outbox_[d].last()) makeRecord(*state, true, records[count++]);
+    }
+    if (count == 0) return true;  // nothing captured yet
+
+    // seq advances only on a successful send so failures (which go over
+    // HTTP instead) don't show up as loss on the server.
+    encodeFrame(records, count, link.binarySupported, datagramSeq_ + 1);
+    if (!link.sendDatagram(frame_)) {
+        for (int i = 0; i < count; ++i) needSnapshot_[records[i].state->deck - 1] = true;
+        return false;
+    }
+    ++datagramSeq_;
+    return true;
+}
+
+bool CVideoSyncPlugin::sendUpdate(const DeckState& state) {
+    ServerLink& link = engine_->link;
+    frame_.clear();
+    state.appendJson(frame_);
+    counters_.requests++;
+    int status = link.post("/api/deck/update", frame_, "application/json");
+    return status >= 200 && status < 300;
+}
+
+void CVideoSyncPlugin::sendStats() {
+    ServerLink& link = engine_->link;
+    auto now = std::chrono::steady_clock::now();
+    uint64_t calls = counters_.vdjCalls.load();
+    double secs = 0.0;
+    if (statsAt_ != std::chrono::steady_clock::time_point{}) {
+        secs = std::chrono::duration<double>(now - statsAt_).count();
+        if (secs > 0) counters_.vdjCallsPerSec = static_cast<uint64_t>((calls - statsCalls_) / secs + 0.5);
+    }
+    statsAt_    = now;
+    statsCalls_ = calls;
+
+    decksReported_ = deckCount_.load();
+    std::string body = "{\"decks\":" + std::to_string(decksReported_)
+                     + ",\"sender\":" + counters_.toJson()
+                     + ",\"link\":" + link.counters.toJson()
+                     + ",\"audio\":" + audioClock_.statsJson()
+                     + ",\"scheduler\":" + engine_->scheduler.statsJson()
+                     + ",\"queries\":" + queries_.statsJson()
+                     + ",\"verbs\":" + verbs_.statsJson()
+                     + ",\"poll\":" + pollStatsJson()
+                     + ",\"budget\":" + budgetStatsJson(secs)
+                     + ",\"engine\":" + engineStatsJson();
+    bool first = true;
+    for (const auto& endpoint : engine_->fanout) {
+        if (!endpoint.enabled()) continue;
+        body += first ? ",\"endpoints\":[" : ",";
+        body += endpoint.statsJson();
+        first = false;
+    }
+    if (!first) body += ']';
+    body += '}';
+    // Best-effort; counters are cumulative so a lost report is harmless.
+    // The reply announces the subscription version.
+    std::string response;
+    int status = link.post("/api/plugin/stats", body, "application/json", &response,
+                            RequestKind::Background);
+    if (status >= 200 && status < 300 && !response.empty()) handleControl(response);
+}
+
+// Fetches the verbs the server wants polled besides DeckState.
+void CVideoSyncPlugin::fetchSubscriptions() {
+    ServerLink& link = engine_->link;
+    std::string response;
+    int status = link.get("/api/plugin/subscriptions", &response, RequestKind::Background);
+    if (status == 404) {
+        subsSupported_ = false;  // older server; retried after a reconnect
+        return;
+    }
+    if (status >= 200 && status < 300 && verbs_.setList(response)) subsStale_ = false;
+}
+
+// Posts the subscribed values that changed since the last call.  A lost
+// post is repaired by the resend after the reconnect that follows.
+void CVideoSyncPlugin::sendVerbs() {
+    ServerLink& link = engine_->link;
+    VerbSubscriptions::Change changes[16];
+    int n;
+    while ((n = verbs_.take(changes, 16)) > 0) {
+        std::string body = "{\"values\":[";
+        for (int i = 0; i < n; ++i) {
+            if (i > 0) body += ',';
+            body += "{\"verb\":";
+            appendJsonString(body, changes[i].verb);
+            body += ",\"deck\":";
+            appendInt(body, changes[i].deck);
+            body += ",\"value\":";
+            appendJsonString(body, changes[i].value);
+            body += '}';
+        }
+        body += "]}";
+        int status = link.post("/api/plugin/verbs", body, "application/json", nullptr,
+                                RequestKind::Background);
+        if (status == 404) return;  // older server: nothing subscribed there anyway
+        if (status < 200 || status >= 300) {
+            verbs_.resendAll();
+            return;
+        }
+    }
 }
@@ -4,23 +4,69 @@
 //
 // A DSP plugin for VirtualDJ 8 that monitors the current deck state
 // (filename, BPM, volume, pitch, play state, etc.) and sends updates
-// via HTTP POST to an external video sync server.
-// The server IP and port are configurable from the VDJ effect settings.
+// via HTTP POST (or an optional WebSocket stream) to an external video
+// sync server.  The server IP, port and transport are configurable from
+// the VDJ effect settings, as are extra endpoints (a backup or recording
+// server) that receive a copy of every update.
+//
+// Polling and sending run on separate threads: the poll tick (one task
+// of the Scheduler thread) publishes the newest DeckState per deck into
+// a lock-free mailbox and the sender drains it, so a slow server costs
+// freshness, never poll timing.
+//
+// Over HTTP and WebSocket the sender sends deltas: a full snapshot with
+// a short track ID when a track loads, then only the fields that changed.
+// The server asks for a resync when it lacks the snapshot a delta needs.
 //
 // Loaded as a Sound Effect — VDJ toggles the effect on/off which
-// triggers OnStart() / OnStop() to begin/end data transmission.
+// triggers OnStart() / OnStop() to begin/end data transmission.  The
+// effect may be loaded on several decks and the master at once; the
+// instances share one poller and sender, hosted by one of them (see
+// rebalanceEngine()), so the host and the server see the same load
+// however many are loaded.
 //////////////////////////////////////////////////////////////////////////
 
 #include "vdjDsp8.h"
+#include "LatestSlot.h"
+#include "ServerLink.h"
+#include "AudioClock.h"
+#include "FanoutEndpoint.h"
+#include "Scheduler.h"
+#include "DeckQueries.h"
+#include "VerbSubscriptions.h"
+#include "FixedString.h"
 #include <string>
 #include <thread>
 #include <atomic>
 #include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// ── Field bits of a delta record (which DeckState fields it carries) ──
+// deck, isAudible and isPlaying are always sent.
+enum : uint16_t {
+    FIELD_ELAPSED    = 1 << 0,
+    FIELD_TOTAL_TIME = 1 << 1,
+    FIELD_VOLUME     = 1 << 2,
+    FIELD_BPM        = 1 << 3,
+    FIELD_PITCH      = 1 << 4,
+    FIELD_FILENAME   = 1 << 5,
+    FIELD_TITLE      = 1 << 6,
+    FIELD_ARTIST     = 1 << 7,
+    FIELD_ALL        = 0xFF,  // a snapshot
+};
 
-// Forward-declare to avoid pulling httplib.h into the header
-namespace httplib { class Client; }
+// Default allowed gap (ms) between a playing deck's elapsed time and the
+// position predicted from its last update before the update is resent.
+constexpr double kDefaultPositionToleranceMs = 15.0;
 
 // ── Data sent to the server on each update ──────────────
+// Inline deck text: as much as one host string read returns (511 bytes).
+using DeckText = FixedString<512>;
+
 struct DeckState {
     int         deck        = 0;
     bool        isAudible   = false;  // is_audible: audible at all (even if volume > 0)
@@ -28,16 +74,52 @@ struct DeckState {
     double      volume      = 0.0;    // get_volume: deck fader volume 0.0–1.0
     int         elapsedMs   = 0;      // get_time elapsed absolute: elapsed time in ms
     double      bpm         = 0.0;    // get_bpm: current deck BPM
-    std::string filename;             // get_filename: song filename (no path)
+    DeckText    filename;             // get_filename: song filename (no path)
     double      pitch       = 100.0;  // get_pitch_value: pitch %, centered on 100%, used for video playbackRate
     int         totalTimeMs = 0;      // get_songlength * 1000: total song length in ms
-    std::string title;                // get_title: song title metadata
-    std::string artist;               // get_artist: song artist metadata
+    DeckText    title;                // get_title: song title metadata
+    DeckText    artist;               // get_artist: song artist metadata
+    int64_t     captureUs   = 0;      // steady-clock time of the poll tick (µs); not compared
 
     bool operator==(const DeckState& o) const;
     bool operator!=(const DeckState& o) const { return !(*this == o); }
 
-    // Serialize to JSON (minimal, no external lib)
+    // Serialize to JSON (minimal, no external lib).  appendJson() writes
+    // into a caller-owned buffer and allocates only if it must grow; with
+    // a track it writes a delta record holding only the given fields.
+    std::string toJson() const;
+    void appendJson(std::string& out, uint16_t fields = FIELD_ALL, uint32_t track = 0) const;
+
+    // Append the binary record (kDeckBinaryType, see VideoSyncPlugin.cpp)
+    void appendBinary(std::string& out, uint16_t fields, uint32_t track) const;
+};
+
+// Copied on every tick and publish, so it must stay a plain memcpy.
+static_assert(std::is_trivially_copyable<DeckState>::value, "DeckState must not own heap memory");
+
+// One deck in an outgoing frame: the state and the fields to send from it.
+struct DeckRecord {
+    const DeckState* state  = nullptr;
+    uint16_t         fields = FIELD_ALL;
+    uint32_t         track  = 0;
+};
+
+// ── Sender counters (reported to the server periodically) ──
+struct SendCounters {
+    std::atomic<uint64_t> published{0};  // deck states handed to the sender
+    std::atomic<uint64_t> coalesced{0};  // unsent states replaced by a newer one
+    std::atomic<uint64_t> sent{0};       // states the server accepted
+    std::atomic<uint64_t> dropped{0};    // states lost to a failed request
+    std::atomic<uint64_t> requests{0};   // HTTP requests issued for deck data
+    std::atomic<uint64_t> snapshots{0};  // full records sent (track load, resync)
+    std::atomic<uint64_t> deltas{0};     // changed-fields-only records sent
+    std::atomic<uint64_t> resyncs{0};    // full resyncs (server request or reconnect)
+    std::atomic<uint64_t> predicted{0};  // playing-deck ticks not sent: position on prediction
+    std::atomic<uint64_t> throttled{0};  // deck changes held back by the deck's update budget
+    std::atomic<uint64_t> clockSyncs{0}; // completed /api/clock exchanges
+    std::atomic<uint64_t> vdjCalls{0};   // GetInfo / GetStringInfo calls
+    std::atomic<uint64_t> vdjCallsPerSec{0};  // over the last stats interval
+
     std::string toJson() const;
 };
 
@@ -47,6 +129,14 @@ enum {
     PARAM_PORT     = 2,
     PARAM_SET_IP   = 3,   // Button – opens VDJ dialog for IP
     PARAM_SET_PORT = 4,   // Button – opens VDJ dialog for Port
+    PARAM_TRANSPORT     = 5,
+    PARAM_SET_TRANSPORT = 6,   // Button – opens VDJ dialog for Transport
+    PARAM_DEADBANDS     = 7,
+    PARAM_SET_DEADBANDS = 8,   // Button – opens VDJ dialog for Deadbands
+    PARAM_ENDPOINTS     = 9,
+    PARAM_SET_ENDPOINTS = 10,  // Button – opens VDJ dialog for extra endpoints
+    PARAM_POLL_RATES     = 11,
+    PARAM_SET_POLL_RATES = 12,  // Button – opens VDJ dialog for poll rates
 };
 
 // ── Plugin class ────────────────────────────────────────
@@ -72,34 +162,258 @@ private:
     // Polling loop (runs in a background thread between OnStart/OnStop)
     void startWorker();
     void stopWorker();
-    void pollLoop();
-    DeckState readDeckState(int deck);
-    void sendUpdate(const DeckState& state);
-    void recreateClient();
+    void pollTick();
+    void sendLoop();
+    void wakeSender();
+    DeckState readDeckState(int deck, int64_t nowUs, const double* batch);
+    bool vdjString(const char* query, char* buf, int size);
+    bool sendUpdate(const DeckState& state);
+    int  sendBatch(const DeckState* const* states, int count);
+    void encodeFrame(const DeckRecord* records, int count, bool binary, uint64_t seq);
+    bool sendDatagram();
+    bool makeRecord(const DeckState& state, bool snapshot, DeckRecord& out);
+    void requestResync();
+    void handleControl(const std::string& msg);
+    void applyDeadbands();
+    void applyEndpoints();
+    void applyPollRates();
+    void publishFanout();
+    void sendStats();
+    void syncClock();
+    void fetchSubscriptions();
+    void sendVerbs();
+    void updateEndpoint();
 
     // ── VDJ variable sync (native set_var_dialog) ───────────
-    void pushParamsToVars();          // push internal buffers → VDJ vars
-    void applyVarChanges();           // read VDJ vars, update params if changed
-    void settingsWatchLoop();         // always-on loop that polls VDJ vars
+    void pushParamsToVars();          // push the snapshot → VDJ vars
+    void applyVarChanges();           // read VDJ vars, publish a new snapshot if changed
+
+    // ── Configuration snapshot ──────────────────────────────
+    // The settings as last accepted, immutable once published and
+    // replaced whole by applyVarChanges(), so every thread reads one
+    // consistent set without locks.  The param buffers below belong to
+    // VDJ's thread: they seed the first snapshot and mirror the current
+    // one for display and the .ini (syncParamBuffers()).
+    struct PluginConfig {
+        std::string ip;
+        std::string port;
+        std::string transport;
+        std::string deadbands;
+        std::string endpoints;
+        std::string pollRates;
+    };
+    using ConfigPtr = std::shared_ptr<const PluginConfig>;
+    ConfigPtr config() const;
+    void publishConfig(const PluginConfig& config);
+    PluginConfig configFromParams() const;
+    void syncParamBuffers();
+    ConfigPtr config_ = std::make_shared<const PluginConfig>();  // std::atomic_load / atomic_store only
 
     // ── Configurable parameters (persisted via DeclareParameterString .ini) ──
     static constexpr int kParamSize = 64;
     char paramIP_[kParamSize]   = "127.0.0.1";
     char paramPort_[kParamSize] = "8090";
+    char paramTransport_[kParamSize] = "http";   // "http", "ws", "udp" or "shm"
+    char paramDeadbands_[kParamSize] = "0.001/0.01/0.01/15";  // volume/pitch/bpm/position ms
+    static constexpr int kEndpointsParamSize = 256;
+    char paramEndpoints_[kEndpointsParamSize] = "none";  // "host:port[@hz],..." or "none"
+    char paramPollRates_[kParamSize] = "500/50/10/500";  // idle/nominal/burst ms, burst hold ms
 
     // ── Settings buttons ────────────────────────────────────
     int setIpBtn_   = 0;
     int setPortBtn_ = 0;
+    int setTransportBtn_ = 0;
+    int setDeadbandsBtn_ = 0;
+    int setEndpointsBtn_ = 0;
+    int setPollRatesBtn_ = 0;
 
     // ── Internals ───────────────────────────────────────
-    int                      pollIntervalMs_ = 50;
-    std::thread              worker_;
+    static constexpr int kMaxDecks        = 8;   // capacity; deckCount_ are in use
+    static constexpr int kStatsIntervalMs = 5000;
+    static constexpr int kMaxFanout       = 3;   // extra endpoints besides the server link
+    static constexpr int kDatagramRefreshMs = 1000;  // resend full state while idle over UDP/shm
+    static constexpr int kResendRetryMs = 250;  // resend decks a failed frame carried
+    static constexpr int kPositionHeartbeatMs = 1000;  // resend a playing deck on prediction
+    static constexpr int kClockIntervalMs = 1000;  // clock exchange period once settled
+    static constexpr int kClockBurstMs    = 200;   // ...and for the first kClockBurst
+    static constexpr int kClockBurst      = 8;
+
+    static constexpr int kSettingsIntervalMs = 200;  // VDJ var watch, even while disabled
+    static constexpr int kCancelRetryMs      = 1;    // stopWorker(): re-cancel period until the sender exits
+    static constexpr int kTaskSlackMs        = 60;   // > nominal poll interval: settings/stats share its wakeups
+
     std::atomic<bool>        running_{false};
-    std::thread              settingsWatcher_;
-    std::atomic<bool>        watcherRunning_{false};
-    std::mutex               httpMutex_;
-    httplib::Client*         httpClient_ = nullptr;
+    std::mutex               varsMu_;     // serializes applyVarChanges() callers (snapshot writers)
 
-    static constexpr int kMaxDecks = 4;
     DeckState lastState_[kMaxDecks];
+
+    // Per-deck read cache (poll tick): the loaded track's metadata and
+    // the inputs that decide when to re-read it.  See readDeckState().
+    struct DeckCache {
+        double      lengthSec = -1.0;   // get_songlength at the last metadata read
+        int64_t     checkedUs = 0;      // when the filename was last confirmed
+        DeckText    filename;
+        DeckText    title;
+        DeckText    artist;
+        double      pitch = -1.0;       // pitch the cached bpm was read at
+        double      bpm   = 0.0;
+    };
+    DeckCache deckCache_[kMaxDecks];
+    static constexpr int kMetaRecheckMs = 1000;
+
+    // Decks 1..deckCount_ of the host layout are polled; the per-deck
+    // arrays beyond are spare capacity.  Probed when the poll starts and
+    // rechecked every kDeckProbeMs, so switching VDJ between 2, 4 and 6
+    // decks is followed within seconds.  A host that answers no probe
+    // gets kDefaultDecks and no recheck until the worker restarts.  See
+    // discoverDecks().
+    static constexpr int kDefaultDecks = 4;   // when the host answers no probe
+    static constexpr int kDeckProbeMs  = 2000;
+    static constexpr int kMirrorSlots  = 16;  // power of two, >= 2 * kMaxDecks
+    static_assert((kMirrorSlots & (kMirrorSlots - 1)) == 0 && kMirrorSlots >= 2 * kMaxDecks,
+                  "mirror table must be a power of two with room to spare");
+    bool discoverDecks(int64_t nowUs);
+    std::atomic<int>         deckCount_{0};       // 0 until the first probe
+    int64_t                  nextDeckProbeUs_ = 0;
+    bool                     deckProbeFailed_ = false;  // no usable answer since startWorker()
+
+    // Precompiled deck query strings and the batched numeric read.
+    DeckQueries              queries_{*this, counters_.vdjCalls};
+    static_assert(kMaxDecks <= DeckQueries::kMaxDecks, "DeckQueries too small");
+
+    // Verbs the server subscribed to for its overlays, beyond DeckState.
+    VerbSubscriptions        verbs_{*this, counters_.vdjCalls};
+    static_assert(kMaxDecks <= VerbSubscriptions::kMaxDecks, "VerbSubscriptions too small");
+
+    // ── Adaptive poll rate (poll tick) ──────────────────
+    // Idle while no deck plays or is audible, nominal during steady
+    // playback, burst while a fader or the pitch moves or after a seek
+    // (and for the hold time after).  Rates come from paramPollRates_.
+    enum PollMode { PollIdle, PollNominal, PollBurst, kPollModes };
+    void setPollMode(PollMode mode);
+    std::string pollStatsJson() const;
+    std::atomic<int>         pollIdleMs_{500};
+    std::atomic<int>         pollNominalMs_{50};
+    std::atomic<int>         pollBurstMs_{10};
+    std::atomic<int>         pollHoldMs_{500};
+    std::atomic<int>         pollMode_{PollNominal};
+    int                      pollPeriodMs_ = 0;     // what the scheduler runs the poll at; 0 until set
+    int64_t                  burstUntilUs_ = 0;
+    double                   tickVolume_[kMaxDecks] = {};  // previous tick, to see faders move
+    double                   tickPitch_[kMaxDecks] = {};
+    double                   tickCrossfader_ = 0.0;
+    std::atomic<uint64_t>    pollTicks_[kPollModes] = {};
+    std::atomic<uint64_t>    bursts_{0};
+
+    // ── Update budget (poll tick) ───────────────────────
+    // Continuous deck changes are sent at most at the deck's share of
+    // kBudgetDecks full-rate decks, weighted by importance; videoDeck_
+    // is the deck the server shows video for (control messages).
+    static constexpr int     kBudgetDecks = 2;
+    static constexpr double  kMinDeckHz = 1.0;
+    void allocateBudget(const DeckState* current, const bool* loaded, int masterDeck, double* allowedHz);
+    std::string budgetStatsJson(double secs);
+    std::atomic<int>         videoDeck_{0};
+    std::atomic<double>      deckWeight_[kMaxDecks] = {};
+    std::atomic<double>      deckAllowedHz_[kMaxDecks] = {};
+    std::atomic<uint64_t>    deckPublished_[kMaxDecks] = {};
+    uint64_t                 statsPublished_[kMaxDecks] = {};  // at the last report (sender thread)
+
+    // Sample clock fed by OnProcessSamples(); times poll ticks and
+    // stamps captureUs while audio is running.
+    AudioClock               audioClock_;
+    bool                     pollAudio_ = false;  // last tick was audio-timed (scheduler thread)
+
+    // ── Sender stage ────────────────────────────────────
+    // pollTick() publishes into outbox_, sendLoop() drains it into the
+    // engine's link.  sendMu_ only guards the wakeup flag; it is never
+    // held across network I/O.
+    std::thread              sender_;
+    std::atomic<bool>        senderExited_{true};   // sendLoop() returned; stopWorker() stops cancelling
+    std::mutex               sendMu_;
+    std::condition_variable  sendCv_;
+    bool                     sendPending_ = false;
+    std::atomic<bool>        statsDue_{false};      // set by the stats task
+    std::chrono::steady_clock::time_point statsAt_{};  // last report, for the call rate
+    uint64_t                 statsCalls_ = 0;
+    LatestSlot<DeckState>    outbox_[kMaxDecks];
+    SendCounters             counters_;
+    uint32_t                 datagramSession_ = 0;  // random per sendLoop() run
+    uint64_t                 datagramSeq_ = 0;
+    std::string              frame_;                // reusable encode buffer (sender thread)
+    // Worst-case JSON frame: every deck a full record with %.6f numbers
+    // of any size and text that is all \u00XX escapes.  frame_ reserves
+    // it once, so encoding never grows.  The server sizes its body limit
+    // the same way (models.MaxDeckRecordBytes in server/internal/models).
+    static constexpr size_t kMaxFrameBytes = 128 + kMaxDecks * (1280 + 3 * (2 + 6 * DeckText::kCapacity));
+
+    // ── Delta state (sender thread) ─────────────────────
+    // sentState_ mirrors what the server holds for each deck; a field is
+    // resent once it differs by more than its deadband.
+    DeckState                sentState_[kMaxDecks];
+    uint32_t                 sentTrack_[kMaxDecks] = {};   // 0 = no snapshot sent
+    bool                     needSnapshot_[kMaxDecks] = {};
+    uint32_t                 nextTrack_ = 1;
+    uint64_t                 linkEpoch_ = 0;
+    int                      decksReported_ = 0;  // deck count in the last stats on this link
+    bool                     resyncPending_ = false;
+
+    // ── Clock exchange (sender thread) ──────────────────
+    // Send and receive times of the previous /api/clock request on the
+    // steady clock captureUs uses; reported with the next one so the
+    // server can complete the sample.
+    int64_t                  clockT0_ = 0;
+    int64_t                  clockT3_ = 0;
+    int                      clockExchanges_ = 0;
+    bool                     clockSupported_ = true;  // false after a 404 (older server)
+
+    // ── Subscriptions (sender thread) ───────────────────
+    bool                     subsStale_ = true;       // server announced another list version
+    bool                     subsSupported_ = true;   // false after a 404 (older server)
+    std::atomic<double>      deadbandVolume_{0.001};
+    std::atomic<double>      deadbandPitch_{0.01};
+    std::atomic<double>      deadbandBpm_{0.01};
+    std::atomic<double>      positionToleranceMs_{kDefaultPositionToleranceMs};  // poll tick
+
+    // ── Process-wide engine ─────────────────────────────
+    // Every loaded instance registers itself; the first enabled one (or
+    // the first loaded, while none is) hosts the settings watch and,
+    // while any instance is enabled, the worker.  The others only add
+    // their enabled state: settings reach the host through the VDJ vars.
+    static void rebalanceEngine();
+    static std::string engineStatsJson();
+    bool                     enabled_ = false;  // between OnStart and OnStop; guarded by the registry
+
+    // The threads and connections of the host: created when this instance
+    // is elected and destroyed when it hands over, so the process holds
+    // one set however many instances are loaded.  engine_ changes only
+    // under varsMu_ and the registry's handover mutex, with every engine
+    // thread stopped; applyVarChanges() may find it empty.
+    struct Engine {
+        ServerLink     link;
+
+        // Fan-out (extra endpoints): pollTick() encodes one full frame
+        // per publishing tick and hands the same buffer to every enabled
+        // endpoint; each sends on its own thread.
+        FanoutEndpoint fanout[kMaxFanout];
+
+        // Frame buffers for the fan-out, each reserving kMaxFrameBytes.
+        // Every endpoint's mailbox holds at most three frames, so one of
+        // kFanoutFrames is always free for the next tick.  Allocated by
+        // hostEngine() and never replaced, so the tick reads them unlocked.
+        static constexpr int kFanoutFrames = 3 * kMaxFanout + 1;
+        std::shared_ptr<std::string> fanoutFrames[kFanoutFrames];
+
+        // One thread runs the poll tick, the settings watch and the stats
+        // heartbeat on absolute deadlines.  Declared last so it stops
+        // before the link and endpoints its tasks use are destroyed.
+        Scheduler      scheduler;
+        int            pollTask     = -1;
+        int            settingsTask = -1;
+        int            statsTask    = -1;
+    };
+    void hostEngine();
+    void retireEngine();
+    // Declared last so it is gone before the state its tasks touch.
+    std::unique_ptr<Engine>  engine_;
 };
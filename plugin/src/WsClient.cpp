@@ -0,0 +1,204 @@
+//////////////////////////////////////////////////////////////////////////
+// WsClient – implementation
+//////////////////////////////////////////////////////////////////////////
+
+#include "WsClient.h"
+
+#include <cstring>
+#include <random>
+
+namespace {
+
+constexpr uint8_t kOpText   = 0x1;
+constexpr uint8_t kOpBinary = 0x2;
+constexpr uint8_t kOpClose  = 0x8;
+constexpr uint8_t kOpPing   = 0x9;
+constexpr uint8_t kOpPong   = 0xA;
+
+std::string base64(const unsigned char* data, size_t len) {
+    static const char* table =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string out;
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t n = static_cast<uint32_t>(data[i]) << 16;
+        if (i + 1 < len) n |= static_cast<uint32_t>(data[i + 1]) << 8;
+        if (i + 2 < len) n |= data[i + 2];
+        out += table[(n >> 18) & 0x3F];
+        out += table[(n >> 12) & 0x3F];
+        out += (i + 1 < len) ? table[(n >> 6) & 0x3F] : '=';
+        out += (i + 2 < len) ? table[n & 0x3F] : '=';
+    }
+    return out;
+}
+
+} // namespace
+
+WsClient::WsClient() {
+    std::random_device rd;
+    maskState_ = rd() | 1u;  // xorshift state must be non-zero
+}
+
+WsClient::~WsClient() {
+    close();
+}
+
+uint32_t WsClient::nextMask() {
+    uint32_t x = maskState_;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return maskState_ = x;
+}
+
+bool WsClient::open(const std::string& address, int port, const std::string& hostHeader,
+                    const char* path, int timeoutMs) {
+    close();
+    net::socket_t sock = net::connectTcp(address, port, timeoutMs, &cancelled_);
+    if (sock == net::kInvalidSocket) return false;
+    {
+        // A cancel() that came before this point found no socket to shut
+        // down; the flag catches it instead.
+        std::lock_guard<std::mutex> lock(sockMu_);
+        if (cancelled_.load()) { net::closeSocket(sock); return false; }
+        sock_ = sock;
+    }
+
+    unsigned char nonce[16];
+    for (int i = 0; i < 16; i += 4) {
+        uint32_t r = nextMask();
+        std::memcpy(nonce + i, &r, 4);
+    }
+
+    std::string request = std::string("GET ") + path + " HTTP/1.1\r\n"
+        "Host: " + hostHeader + "\r\n"
+        "Upgrade: websocket\r\n"
+        "Connection: Upgrade\r\n"
+        "Sec-WebSocket-Key: " + base64(nonce, sizeof(nonce)) + "\r\n"
+        "Sec-WebSocket-Version: 13\r\n\r\n";
+    if (!net::sendAll(sock_, request.data(), request.size())) { close(); return false; }
+
+    // Read the response header; anything after it is already frame data.
+    char buf[1024];
+    size_t headerEnd = std::string::npos;
+    while (headerEnd == std::string::npos) {
+        if (rx_.size() > 8192 || !net::waitReadable(sock_, timeoutMs, &cancelled_)) { close(); return false; }
+        int n = net::recvSome(sock_, buf, sizeof(buf));
+        if (n <= 0) { close(); return false; }
+        rx_.append(buf, static_cast<size_t>(n));
+        headerEnd = rx_.find("\r\n\r\n");
+    }
+
+    // "HTTP/1.1 101 Switching Protocols"
+    if (rx_.compare(0, 12, "HTTP/1.1 101") != 0) { close(); return false; }
+    rx_.erase(0, headerEnd + 4);
+    return true;
+}
+
+void WsClient::close() {
+    if (sock_ != net::kInvalidSocket) {
+        std::lock_guard<std::mutex> lock(sockMu_);
+        net::closeSocket(sock_);
+        sock_ = net::kInvalidSocket;
+    }
+    rx_.clear();
+}
+
+// Shutting the socket down (not closing it) wakes a blocked send or recv
+// without letting the descriptor be reused under the owning thread.
+void WsClient::cancel() {
+    std::lock_guard<std::mutex> lock(sockMu_);
+    cancelled_ = true;
+    net::shutdownSocket(sock_);
+}
+
+bool WsClient::sendText(const std::string& payload) {
+    return sendFrame(kOpText, payload.data(), payload.size());
+}
+
+bool WsClient::sendBinary(const std::string& payload) {
+    return sendFrame(kOpBinary, payload.data(), payload.size());
+}
+
+bool WsClient::ping() {
+    return sendFrame(kOpPing, nullptr, 0);
+}
+
+bool WsClient::sendFrame(uint8_t opcode, const char* data, size_t len) {
+    if (!isOpen()) return false;
+
+    tx_.clear();
+    tx_ += static_cast<char>(0x80 | opcode);  // FIN + opcode
+    if (len < 126) {
+        tx_ += static_cast<char>(0x80 | len);
+    } else if (len <= 0xFFFF) {
+        tx_ += static_cast<char>(0x80 | 126);
+        tx_ += static_cast<char>((len >> 8) & 0xFF);
+        tx_ += static_cast<char>(len & 0xFF);
+    } else {
+        tx_ += static_cast<char>(0x80 | 127);
+        for (int shift = 56; shift >= 0; shift -= 8) {
+            tx_ += static_cast<char>((static_cast<uint64_t>(len) >> shift) & 0xFF);
+        }
+    }
+
+    uint32_t maskWord = nextMask();
+    unsigned char mask[4];
+    std::memcpy(mask, &maskWord, 4);
+    tx_.append(reinterpret_cast<const char*>(mask), 4);
+
+    size_t start = tx_.size();
+    tx_.append(data ? data : "", len);
+    for (size_t i = 0; i < len; ++i) tx_[start + i] ^= static_cast<char>(mask[i & 3]);
+
+    if (!net::sendAll(sock_, tx_.data(), tx_.size())) { close(); return false; }
+    return true;
+}
+
+bool WsClient::poll(const std::function<void(const std::string&)>& onMessage) {
+    if (!isOpen()) return false;
+
+    char buf[4096];
+    while (net::waitReadable(sock_, 0)) {
+        int n = net::recvSome(sock_, buf, sizeof(buf));
+        if (n <= 0) { close(); return false; }
+        rx_.append(buf, static_cast<size_t>(n));
+    }
+
+    size_t pos = 0;
+    while (rx_.size() - pos >= 2) {
+        auto byte = [&](size_t i) { return static_cast<uint8_t>(rx_[pos + i]); };
+        uint8_t opcode = byte(0) & 0x0F;
+        bool    masked = (byte(1) & 0x80) != 0;
+        uint64_t len   = byte(1) & 0x7F;
+        size_t header  = 2;
+        if (len == 126) {
+            if (rx_.size() - pos < 4) break;
+            len = (static_cast<uint64_t>(byte(2)) << 8) | byte(3);
+            header = 4;
+        } else if (len == 127) {
+            if (rx_.size() - pos < 10) break;
+            len = 0;
+            for (size_t i = 0; i < 8; ++i) len = (len << 8) | byte(2 + i);
+            header = 10;
+        }
+        if (len > kMaxMessage) { close(); return false; }
+        size_t maskOff = header;
+        if (masked) header += 4;
+        if (rx_.size() - pos < header + len) break;
+
+        std::string payload = rx_.substr(pos + header, static_cast<size_t>(len));
+        if (masked) {
+            for (size_t i = 0; i < payload.size(); ++i) payload[i] ^= rx_[pos + maskOff + (i & 3)];
+        }
+        pos += header + static_cast<size_t>(len);
+
+        switch (opcode) {
+            case kOpClose: close(); return false;
+            case kOpPing:  if (!sendFrame(kOpPong, payload.data(), payload.size())) return false; break;
+            case kOpPong:  break;
+            default:       onMessage(payload); break;
+        }
+    }
+    rx_.erase(0, pos);
+    return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// WsClient – minimal RFC 6455 WebSocket client
+//
+// One full-duplex TCP connection for streaming deck frames to the server
+// without waiting for replies.  Outbound frames are masked as the RFC
+// requires; inbound control messages are read without blocking via
+// poll().  No fragmentation and no extensions: the server is ours.
+//
+// Not thread-safe: owned by the sending thread (through ServerLink),
+// except cancel(), which any thread may call to break a blocked open or
+// send.
+//////////////////////////////////////////////////////////////////////////
+
+#include "NetSocket.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+class WsClient {
+public:
+    WsClient();
+    ~WsClient();
+
+    // Connects to a numeric address and performs the HTTP upgrade.
+    // hostHeader is sent as the Host header (host:port).
+    bool open(const std::string& address, int port, const std::string& hostHeader,
+              const char* path, int timeoutMs);
+    void close();
+    bool isOpen() const { return sock_ != net::kInvalidSocket; }
+
+    // Fails an open() or send in progress within net::kCancelSliceMs and
+    // every later open() until resume().  Any thread.
+    void cancel();
+    void resume() { cancelled_ = false; }
+
+    // Sends one unfragmented text/binary message. False (and closed) on error.
+    bool sendText(const std::string& payload);
+    bool sendBinary(const std::string& payload);
+    bool ping();
+
+    // Consumes whatever has arrived without blocking and calls onMessage
+    // for each complete text/binary message. Answers pings. Returns false
+    // (and closes) if the server closed or the socket failed.
+    bool poll(const std::function<void(const std::string&)>& onMessage);
+
+private:
+    bool sendFrame(uint8_t opcode, const char* data, size_t len);
+    uint32_t nextMask();
+
+    static constexpr size_t kMaxMessage = 1 << 20;
+
+    net::socket_t sock_ = net::kInvalidSocket;  // replaced under sockMu_ (cancel() reads it)
+    std::mutex    sockMu_;
+    std::atomic<bool> cancelled_{false};
+    std::string   rx_;         // inbound bytes not yet parsed into frames
+    std::string   tx_;         // reusable outbound frame buffer
+    uint32_t      maskState_;  // xorshift state for masking keys
+};
@@ -0,0 +1,94 @@
+//////////////////////////////////////////////////////////////////////////
+// AllocGuardTest – the poll tick and frame encode never allocate
+//
+// Built with VDJSYNC_ALLOC_GUARD, so the plugin aborts the test on the
+// first steady-state poll tick or frame encode that touches the heap
+// (see AllocGuard.h).  The fake host changes deck 1 every
+// FakeHost::kToggleMs, so most ticks publish: a frame for the server
+// and one for a fan-out endpoint, more of them than the endpoint's
+// frame buffers, so the buffers are reused.
+//
+// The endpoint is configured before the plugin loads, and once more
+// through its button while the poll tick is publishing, as a user
+// would from VDJ's UI thread (run under ThreadSanitizer to check the
+// handover).
+//////////////////////////////////////////////////////////////////////////
+
+#include "FakeHost.h"
+#include "TestSupport.h"
+#include "VideoSyncPlugin.h"
+
+namespace {
+
+const char* reply(const std::string& line) {
+    return line.rfind("GET /api/ping ", 0) == 0 ? TestServer::kOk : TestServer::kNoContent;
+}
+
+void configure(FakeHost& host, const TestServer& server) {
+    host.setVar("$vdjVideoSyncAddr", "127.0.0.1");
+    host.setVar("$vdjVideoSyncPort", server.port().c_str());
+    host.setVar("$vdjVideoSyncTransport", "http");
+}
+
+CVideoSyncPlugin* start(FakeHost& host) {
+    auto* plugin = new CVideoSyncPlugin();
+    plugin->cb = &host;
+    plugin->SampleRate = 48000;
+    plugin->OnLoad();
+    plugin->OnStart();
+    return plugin;
+}
+
+void stop(CVideoSyncPlugin* plugin) {
+    plugin->OnStop();
+    plugin->Release();
+}
+
+// Still here after stop(): no tick allocated.  Check that the ticks did
+// run and publish, to both servers.
+void checkPublished(const char* name, const FakeHost& host, const TestServer& server,
+                    const TestServer& fanout) {
+    std::printf("%s: host calls %llu, server requests %d, fan-out requests %d\n", name,
+                static_cast<unsigned long long>(host.calls()), server.requests(),
+                fanout.requests());
+    CHECK(host.calls() > 100);
+    CHECK(server.requests() > 10);
+    CHECK(fanout.requests() > 20);
+}
+
+void testEndpointAtLoad() {
+    TestServer server(reply);
+    TestServer fanout(reply);
+    FakeHost host(4);
+    configure(host, server);
+    host.setVar("$vdjVideoSyncEndpoints", ("127.0.0.1:" + fanout.port()).c_str());
+
+    CVideoSyncPlugin* plugin = start(host);
+    std::this_thread::sleep_for(std::chrono::milliseconds(3000));
+    stop(plugin);
+    checkPublished("endpoint at load", host, server, fanout);
+}
+
+void testEndpointWhileRunning() {
+    TestServer server(reply);
+    TestServer fanout(reply);
+    FakeHost host(4);
+    configure(host, server);
+
+    CVideoSyncPlugin* plugin = start(host);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    CHECK(fanout.requests() == 0);
+    host.setVar("$vdjVideoSyncEndpoints", ("127.0.0.1:" + fanout.port()).c_str());
+    CHECK(host.press(*plugin, PARAM_SET_ENDPOINTS));
+    std::this_thread::sleep_for(std::chrono::milliseconds(3000));
+    stop(plugin);
+    checkPublished("endpoint while running", host, server, fanout);
+}
+
+} // namespace
+
+int main() {
+    testEndpointAtLoad();
+    testEndpointWhileRunning();
+    return failures();
+}
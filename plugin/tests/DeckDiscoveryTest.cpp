@@ -0,0 +1,95 @@
+//////////////////////////////////////////////////////////////////////////
+// DeckDiscoveryTest – the plugin follows the host's deck layout
+//
+// DeckQueries::exists() must answer for exactly the host's decks.  The
+// plugin walks them when polling starts and rechecks every 2s; a host
+// that answers no deck gets the default layout and is not walked again
+// until the worker restarts.  Probes past the polled decks are the only
+// reads of those decks, so the fake host's per-deck counts show them.
+//////////////////////////////////////////////////////////////////////////
+
+#include "DeckQueries.h"
+#include "FakeHost.h"
+#include "TestSupport.h"
+#include "VideoSyncPlugin.h"
+
+namespace {
+
+// Longer than one recheck interval (kDeckProbeMs).
+constexpr auto kPastRecheck = std::chrono::milliseconds(2500);
+
+void testExists() {
+    for (int decks : {0, 2, 6}) {
+        FakeHost host(decks);
+        IVdjPlugin8 vdj;
+        vdj.cb = &host;
+        std::atomic<uint64_t> calls{0};
+        DeckQueries queries(vdj, calls);
+        queries.compile(DeckQueries::kMaxDecks);
+        for (int d = 1; d <= DeckQueries::kMaxDecks; ++d) {
+            if (queries.exists(d) != (d <= decks)) {
+                std::fprintf(stderr, "layout of %d decks: exists(%d) wrong\n", decks, d);
+                CHECK(false);
+            }
+        }
+        CHECK(calls == DeckQueries::kMaxDecks);
+    }
+}
+
+// Runs a plugin on host for the given time, with the server link
+// pointed at server.
+void run(FakeHost& host, TestServer& server, std::chrono::milliseconds time, int restarts = 0) {
+    host.setVar("$vdjVideoSyncAddr", "127.0.0.1");
+    host.setVar("$vdjVideoSyncPort", server.port().c_str());
+    auto* plugin = new CVideoSyncPlugin();
+    plugin->cb = &host;
+    plugin->OnLoad();
+    for (int i = 0; i <= restarts; ++i) {
+        plugin->OnStart();
+        std::this_thread::sleep_for(time);
+        plugin->OnStop();
+    }
+    plugin->Release();
+}
+
+const char* reply(const std::string& line) {
+    return line.rfind("GET /api/ping ", 0) == 0 ? TestServer::kOk : TestServer::kNoContent;
+}
+
+// Six decks: the first walk stops at deck 7, and so does every recheck.
+void testRecheck() {
+    TestServer server(reply);
+    FakeHost host(6);
+    run(host, server, kPastRecheck);
+    std::printf("6 decks: deck 7 probed %llu times\n",
+                static_cast<unsigned long long>(host.volumeReads(7)));
+    CHECK(host.volumeReads(7) >= 2);
+    CHECK(host.volumeReads(8) == 0);
+}
+
+// No deck answers: the default 4 decks are polled, and deck 5 (the
+// first a recheck would probe) is only tried once the worker restarts.
+void testFailedWalk() {
+    TestServer server(reply);
+    FakeHost host(0);
+    run(host, server, kPastRecheck);
+    std::printf("no decks: deck 5 probed %llu times\n",
+                static_cast<unsigned long long>(host.volumeReads(5)));
+    CHECK(host.volumeReads(1) > 0);
+    CHECK(host.volumeReads(5) == 0);
+
+    FakeHost restarted(0);
+    run(restarted, server, std::chrono::milliseconds(300), 1);
+    std::printf("no decks, restarted: deck 5 probed %llu times\n",
+                static_cast<unsigned long long>(restarted.volumeReads(5)));
+    CHECK(restarted.volumeReads(5) == 1);
+}
+
+} // namespace
+
+int main() {
+    testExists();
+    testRecheck();
+    testFailedWalk();
+    return failures();
+}
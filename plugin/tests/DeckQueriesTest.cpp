@@ -0,0 +1,80 @@
+//////////////////////////////////////////////////////////////////////////
+// DeckQueriesTest – when the composite query is trusted
+//
+// DeckQueries::batch() reads every deck in one host call once the
+// composite result has matched the per-verb reads.  A failed composite
+// read is retried, before verification no sooner than
+// kVerifyIntervalUs later; kMaxBatchFailures in a row turn batching off
+// for good.
+//////////////////////////////////////////////////////////////////////////
+
+#include "DeckQueries.h"
+#include "FakeHost.h"
+#include "TestSupport.h"
+
+namespace {
+
+constexpr int     kDecks    = 4;
+constexpr int64_t kInterval = DeckQueries::kVerifyIntervalUs;
+
+struct Reader {
+    explicit Reader(int compositeFailures) : host(kDecks), queries(vdj, calls) {
+        vdj.cb = &host;
+        queries.compile(kDecks);
+        host.failComposites(compositeFailures);
+    }
+
+    // One batch() at nowUs: whether it succeeded, and the host calls it made.
+    bool read(int64_t nowUs, uint64_t& hostCalls) {
+        uint64_t before = calls;
+        bool ok = queries.batch(nowUs, out, globals);
+        hostCalls = calls - before;
+        return ok;
+    }
+
+    FakeHost              host;
+    IVdjPlugin8           vdj;
+    std::atomic<uint64_t> calls{0};
+    DeckQueries           queries;
+    double                out[DeckQueries::kMaxDecks][DeckQueries::kNumeric] = {};
+    double                globals[DeckQueries::kGlobals] = {};
+};
+
+// Two failures before verification: each retry waits for the interval,
+// and the third read verifies the composite form.
+void testRetriedBeforeVerification() {
+    Reader reader(DeckQueries::kMaxBatchFailures - 1);
+    uint64_t hostCalls = 0;
+    int64_t now = 0;
+    for (int i = 0; i < DeckQueries::kMaxBatchFailures - 1; ++i, now += kInterval) {
+        CHECK(!reader.read(now, hostCalls));
+        CHECK(hostCalls == 1);
+        CHECK(!reader.read(now + kInterval / 2, hostCalls));
+        CHECK(hostCalls == 0);  // paced
+    }
+    CHECK(reader.read(now, hostCalls));
+    CHECK(hostCalls > 1);  // the composite and the per-verb reads it is checked against
+    CHECK(reader.read(now + 1, hostCalls));
+    CHECK(hostCalls == 1);
+}
+
+// kMaxBatchFailures in a row: batching stays off.
+void testDisabled() {
+    Reader reader(DeckQueries::kMaxBatchFailures);
+    uint64_t hostCalls = 0;
+    int64_t now = 0;
+    for (int i = 0; i < DeckQueries::kMaxBatchFailures; ++i, now += kInterval) {
+        CHECK(!reader.read(now, hostCalls));
+        CHECK(hostCalls == 1);
+    }
+    CHECK(!reader.read(now + 10 * kInterval, hostCalls));
+    CHECK(hostCalls == 0);
+}
+
+} // namespace
+
+int main() {
+    testRetriedBeforeVerification();
+    testDisabled();
+    return failures();
+}
@@ -0,0 +1,149 @@
+//////////////////////////////////////////////////////////////////////////
+// FakeHost – implementation
+//////////////////////////////////////////////////////////////////////////
+
+#include "FakeHost.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// Splits "deck N verb" into N and verb.  False for other queries.
+bool parseDeck(const char* query, int& deck, const char*& verb) {
+    if (std::strncmp(query, "deck ", 5) != 0) return false;
+    char* end = nullptr;
+    deck = static_cast<int>(std::strtol(query + 5, &end, 10));
+    if (end == query + 5 || *end != ' ') return false;
+    verb = end + 1;
+    return true;
+}
+
+bool loaded(int deck) { return deck == 1 || deck == 2; }
+
+} // namespace
+
+void FakeHost::setVar(const char* name, const char* value) {
+    char query[kVarBytes];
+    std::snprintf(query, sizeof query, "get_var %s", name);
+    std::lock_guard<std::mutex> lock(varsMu_);
+    int i = 0;
+    while (i < vars_ && std::strcmp(varNames_[i], query) != 0) ++i;
+    if (i == kMaxVars) return;
+    if (i == vars_) {
+        std::memcpy(varNames_[i], query, sizeof query);
+        vars_++;
+    }
+    std::snprintf(varValues_[i], kVarBytes, "%s", value);
+}
+
+bool FakeHost::press(IVdjPlugin8& plugin, int id) {
+    int* button = id >= 0 && id < kMaxParams ? buttons_[id].load() : nullptr;
+    if (!button) return false;
+    *button = 1;
+    plugin.OnParameter(id);
+    return true;
+}
+
+HRESULT FakeHost::DeclareParameter(void* parameter, int type, int id, const char*,
+                                   const char*, float) {
+    calls_++;
+    if (type == VDJPARAM_BUTTON && id >= 0 && id < kMaxParams)
+        buttons_[id] = static_cast<int*>(parameter);
+    return S_OK;
+}
+
+HRESULT FakeHost::SendCommand(const char*) {
+    calls_++;
+    return S_OK;
+}
+
+HRESULT FakeHost::GetInfo(const char* command, double* result) {
+    calls_++;
+    return number(command, *result) ? S_OK : E_FAIL;
+}
+
+HRESULT FakeHost::GetStringInfo(const char* command, char* result, int size) {
+    calls_++;
+    if (size <= 0) return E_FAIL;
+    result[0] = '\0';
+    {
+        std::lock_guard<std::mutex> lock(varsMu_);
+        for (int i = 0; i < vars_; ++i) {
+            if (std::strcmp(command, varNames_[i]) == 0) {
+                std::snprintf(result, size, "%s", varValues_[i]);
+                return S_OK;
+            }
+        }
+    }
+    if (std::strncmp(command, "get_var ", 8) == 0) return S_OK;  // unset: empty
+    if (std::strncmp(command, "get_text \"", 10) == 0) {
+        if (compositeFailures_.load() > 0) {
+            compositeFailures_--;
+            return E_FAIL;
+        }
+        return composite(command + 10, result, size) ? S_OK : E_FAIL;
+    }
+    return deckText(command, result, size) ? S_OK : E_FAIL;
+}
+
+double FakeHost::elapsedMs() const {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start_).count();
+}
+
+// Numeric verbs, per deck and mixer-wide.
+bool FakeHost::number(const char* query, double& out) {
+    if (std::strcmp(query, "crossfader") == 0)     { out = 0.5; return true; }
+    if (std::strcmp(query, "get_activedeck") == 0) { out = 1.0; return true; }
+
+    int deck = 0;
+    const char* verb = nullptr;
+    if (!parseDeck(query, deck, verb)) return false;
+    if (std::strcmp(verb, "get_volume") == 0 && deck >= 1 && deck <= kMaxDecks) volumeReads_[deck - 1]++;
+    if (deck < 1 || deck > decks_) return false;
+
+    bool track = loaded(deck);
+    double ms = elapsedMs();
+    if (std::strcmp(verb, "get_songlength") == 0) out = track ? 300.0 : 0.0;
+    else if (std::strcmp(verb, "is_audible") == 0)
+        out = track && !(deck == 1 && static_cast<int64_t>(ms / kToggleMs) % 2 == 1);
+    else if (std::strcmp(verb, "play") == 0)            out = track;
+    else if (std::strcmp(verb, "get_volume") == 0)      out = 0.8;
+    else if (std::strcmp(verb, "get_time elapsed absolute") == 0) out = track ? static_cast<int64_t>(ms) : 0.0;
+    else if (std::strcmp(verb, "get_pitch_value") == 0) out = 100.0;
+    else if (std::strcmp(verb, "get_bpm") == 0)         out = track ? 124.0 : 0.0;
+    else return false;
+    return true;
+}
+
+bool FakeHost::deckText(const char* query, char* result, int size) const {
+    int deck = 0;
+    const char* verb = nullptr;
+    if (!parseDeck(query, deck, verb) || deck < 1 || deck > decks_) return false;
+    if (!loaded(deck)) return true;
+    if (std::strcmp(verb, "get_filename") == 0)    std::snprintf(result, size, "Artist %d - Track.mp4", deck);
+    else if (std::strcmp(verb, "get_title") == 0)  std::snprintf(result, size, "Track");
+    else if (std::strcmp(verb, "get_artist") == 0) std::snprintf(result, size, "Artist %d", deck);
+    return true;
+}
+
+// `query`|`query`|... up to the closing quote, answered as value|value|...
+bool FakeHost::composite(const char* query, char* result, int size) {
+    int len = 0;
+    char one[64];
+    for (const char* p = query; *p == '`';) {
+        const char* end = std::strchr(p + 1, '`');
+        if (!end || end - p - 1 >= static_cast<long>(sizeof one)) return false;
+        std::memcpy(one, p + 1, end - p - 1);
+        one[end - p - 1] = '\0';
+        double value = 0.0;
+        if (!number(one, value)) return false;
+        len += std::snprintf(result + len, size - len, "%s%.6f", len ? "|" : "", value);
+        if (len >= size) return false;
+        p = end + 1;
+        if (*p == '|') ++p;
+    }
+    return len > 0;
+}
@@ -0,0 +1,78 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// FakeHost – a VirtualDJ host for the plugin tests
+//
+// Answers the deck, mixer and variable queries the plugin makes, for a
+// layout of decks() decks: deck queries beyond it fail, as VDJ's do.
+// Decks 1 and 2 have a track loaded and playing, with elapsed time
+// following the wall clock; the others are empty.  Deck 1 turns audible
+// and back every kToggleMs, a discrete change the plugin always sends.
+// The composite get_text query is answered field by field.
+//
+// Buttons the plugin declares can be pressed like in VDJ's effect panel,
+// and variables changed while the plugin runs, as set_var_dialog does.
+//
+// Never allocates once constructed, so a guard build (AllocGuard.h) can
+// check the plugin's poll tick with it.  Safe from any thread.
+//////////////////////////////////////////////////////////////////////////
+
+#include "vdjPlugin8.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+class FakeHost : public IVdjCallbacks8 {
+public:
+    static constexpr int kToggleMs = 100;
+
+    explicit FakeHost(int decks) : decks_(decks) {}
+
+    // Answer for "get_var $name", from now on.
+    void setVar(const char* name, const char* value);
+
+    // Presses the button the plugin declared with id, from the calling
+    // thread (VDJ's UI thread).  False if there is no such button.
+    bool press(IVdjPlugin8& plugin, int id);
+
+    // The next `count` composite queries fail.
+    void failComposites(int count) { compositeFailures_ = count; }
+
+    int decks() const { return decks_; }
+
+    // Host calls so far, and the "deck N get_volume" reads of one deck
+    // among them (the plugin probes the deck layout with those).
+    uint64_t calls() const { return calls_; }
+    uint64_t volumeReads(int deck) const {
+        return deck >= 1 && deck <= kMaxDecks ? volumeReads_[deck - 1].load() : 0;
+    }
+
+    HRESULT SendCommand(const char* command) override;
+    HRESULT GetInfo(const char* command, double* result) override;
+    HRESULT GetStringInfo(const char* command, char* result, int size) override;
+    HRESULT DeclareParameter(void* parameter, int type, int id, const char* name,
+                             const char* shortName, float defaultValue) override;
+
+private:
+    bool number(const char* query, double& out);
+    bool deckText(const char* query, char* result, int size) const;
+    bool composite(const char* query, char* result, int size);
+    double elapsedMs() const;
+
+    static constexpr int kMaxDecks = 8;
+    static constexpr int kMaxVars  = 8;
+    static constexpr int kVarBytes = 256;
+    static constexpr int kMaxParams = 32;
+
+    int  decks_;
+    std::mutex varsMu_;  // vars may change while the plugin reads them
+    char varNames_[kMaxVars][kVarBytes] = {};
+    char varValues_[kMaxVars][kVarBytes] = {};
+    int  vars_ = 0;
+    std::atomic<int*> buttons_[kMaxParams] = {};  // by parameter id
+    std::chrono::steady_clock::time_point start_ = std::chrono::steady_clock::now();
+    std::atomic<uint64_t> calls_{0};
+    std::atomic<int> compositeFailures_{0};
+    std::atomic<uint64_t> volumeReads_[kMaxDecks] = {};
+};
@@ -0,0 +1,98 @@
+//////////////////////////////////////////////////////////////////////////
+// FanoutEndpointTest – what a fan-out endpoint's server receives
+//
+// One frame is published and nothing newer follows, as when every deck
+// is paused.  A server error with the connection still up must not lose
+// it: the endpoint resends it on its retry timer until the server takes
+// it.  A server without /api/deck/batch is not retried.  The server is
+// told the host's deck count before a frame with more decks than it
+// accepts, and after the frame that drops decks.
+//////////////////////////////////////////////////////////////////////////
+
+#include "FanoutEndpoint.h"
+#include "TestSupport.h"
+
+namespace {
+
+constexpr char kServerError[] = "HTTP/1.1 500 Internal Server Error\r\nContent-Length: 0\r\n\r\n";
+constexpr char kNotFound[]    = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n";
+constexpr char kFrame[]       = "{\"decks\":[]}";
+
+// Long enough for a few retries (FanoutEndpoint::kResendRetryMs).
+constexpr auto kWait = std::chrono::milliseconds(1500);
+
+bool isBatch(const std::string& request) {
+    return request.rfind("POST /api/deck/batch ", 0) == 0;
+}
+
+const char* reply(const std::string& line) {
+    return line.rfind("GET /api/ping ", 0) == 0 ? TestServer::kOk : TestServer::kNoContent;
+}
+
+// The requests after the connection prewarm.
+std::vector<std::string> posts(const TestServer& server) {
+    std::vector<std::string> out;
+    for (const auto& request : server.received())
+        if (request.rfind("GET /api/ping ", 0) != 0) out.push_back(request);
+    return out;
+}
+
+// Publishes one frame to a server that answers its first `errors` batch
+// posts with errorReply, and returns how many batch posts it saw.
+int batchesOfOneFrame(const char* errorReply, int errors) {
+    std::atomic<int> batches{0};
+    TestServer server([&](const std::string& line) -> const char* {
+        if (!isBatch(line)) return reply(line);
+        return ++batches <= errors ? errorReply : TestServer::kNoContent;
+    });
+    FanoutEndpoint endpoint;
+    endpoint.configure("127.0.0.1", server.port(), 0);
+    endpoint.start();
+    endpoint.publish(std::make_shared<const std::string>(kFrame), 4);
+    std::this_thread::sleep_for(kWait);
+    endpoint.stop();
+    return batches;
+}
+
+void testServerError() {
+    int batches = batchesOfOneFrame(kServerError, 2);
+    std::printf("two 500s: %d batch posts\n", batches);
+    CHECK(batches == 3);
+}
+
+void testNotFound() {
+    int batches = batchesOfOneFrame(kNotFound, 1);
+    std::printf("404: %d batch posts\n", batches);
+    CHECK(batches == 1);
+}
+
+// Six decks, then two: the count goes out first, then last.
+void testDeckCount() {
+    TestServer server(reply);
+    FanoutEndpoint endpoint;
+    endpoint.configure("127.0.0.1", server.port(), 0);
+    endpoint.start();
+    endpoint.publish(std::make_shared<const std::string>(kFrame), 6);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    endpoint.publish(std::make_shared<const std::string>(kFrame), 2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    endpoint.stop();
+
+    std::vector<std::string> got = posts(server);
+    for (const auto& request : got) std::printf("deck count: %s\n", request.c_str());
+    CHECK(got.size() == 4);
+    if (got.size() != 4) return;
+    CHECK(got[0] == "POST /api/plugin/stats HTTP/1.1 {\"decks\":6}");
+    CHECK(isBatch(got[1]));
+    CHECK(isBatch(got[2]));
+    CHECK(got[3] == "POST /api/plugin/stats HTTP/1.1 {\"decks\":2}");
+}
+
+} // namespace
+
+int main() {
+    testServerError();
+    testNotFound();
+    testDeckCount();
+    return failures();
+}
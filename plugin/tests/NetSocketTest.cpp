@@ -0,0 +1,67 @@
+//////////////////////////////////////////////////////////////////////////
+// NetSocketTest – waits on a descriptor past FD_SETSIZE
+//
+// VDJ holds many files and sockets of its own, so the plugin's sockets
+// can be numbered at or above FD_SETSIZE, where select() cannot be used.
+// The test fills the descriptor table up to there, then connects to a
+// loopback server and waits for its reply on the high descriptor.  A
+// select() there writes past its fd_set, which AddressSanitizer
+// reports.  Skipped when the process may not open that many descriptors.
+//////////////////////////////////////////////////////////////////////////
+
+#include "NetSocket.h"
+#include "TestSupport.h"
+
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int kDescriptors = FD_SETSIZE + 16;
+
+// Raises the soft descriptor limit to kDescriptors.  False if the hard
+// limit is lower.
+bool raiseLimit() {
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return false;
+    if (limit.rlim_cur >= static_cast<rlim_t>(kDescriptors)) return true;
+    if (limit.rlim_max != RLIM_INFINITY && limit.rlim_max < static_cast<rlim_t>(kDescriptors)) return false;
+    limit.rlim_cur = kDescriptors;
+    return setrlimit(RLIMIT_NOFILE, &limit) == 0;
+}
+
+void testHighDescriptor() {
+    if (!raiseLimit()) {
+        std::printf("skipped: cannot open %d descriptors\n", kDescriptors);
+        return;
+    }
+    TestServer server([](const std::string&) { return TestServer::kNoContent; });
+
+    std::vector<int> filler;
+    for (int fd = ::dup(0); fd >= 0; fd = ::dup(0)) {
+        filler.push_back(fd);
+        if (fd >= FD_SETSIZE - 1) break;
+    }
+
+    net::socket_t s = net::connectTcp("127.0.0.1", std::stoi(server.port()), 1000);
+    std::printf("connected on descriptor %d (FD_SETSIZE %d)\n", static_cast<int>(s), FD_SETSIZE);
+    CHECK(s >= FD_SETSIZE);
+    if (s != net::kInvalidSocket) {
+        static const char kRequest[] = "GET /api/ping HTTP/1.1\r\nHost: test\r\n\r\n";
+        CHECK(!net::waitReadable(s, 0));
+        CHECK(net::sendAll(s, kRequest, sizeof kRequest - 1));
+        CHECK(net::waitReadable(s, 1000));
+        char reply[64];
+        CHECK(net::recvSome(s, reply, sizeof reply) > 0);
+        net::closeSocket(s);
+    }
+    for (int fd : filler) ::close(fd);
+}
+
+} // namespace
+
+int main() {
+    testHighDescriptor();
+    return failures();
+}
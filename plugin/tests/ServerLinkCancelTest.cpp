@@ -0,0 +1,84 @@
+//////////////////////////////////////////////////////////////////////////
+// ServerLinkCancelTest – cancel() unblocks a request the server never
+// answers
+//
+// OnStop joins the sending thread after ServerLink::cancel(), so a hung
+// server must not hold it for the request timeout (2s for the prewarm
+// and background requests).  Both waits below are cancelled 100ms in
+// and must return well inside kBoundMs.
+//////////////////////////////////////////////////////////////////////////
+
+#include "ServerLink.h"
+#include "TestSupport.h"
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr auto   kCancelAfter = std::chrono::milliseconds(100);
+constexpr double kBoundMs     = 500.0;
+
+// Runs request on its own thread, cancels link kCancelAfter later and
+// returns how long the request took to return after cancel().
+template <typename Request>
+double cancelDuring(ServerLink& link, Request request) {
+    std::thread sender(request);
+    std::this_thread::sleep_for(kCancelAfter);
+    auto start = clock_type::now();
+    link.cancel();
+    sender.join();
+    return elapsedMs(start);
+}
+
+// The server accepts the connection and never replies, so the prewarm
+// GET /api/ping hangs in the read.
+void testCancelDuringConnect() {
+    TestServer server([](const std::string&) -> const char* { return nullptr; });
+    ServerLink link;
+    link.setEndpoint("127.0.0.1", server.port(), Transport::Http);
+
+    bool connected = true;
+    double ms = cancelDuring(link, [&] { connected = link.ensureConnected(); });
+    std::printf("cancel during prewarm: returned after %.1f ms\n", ms);
+    CHECK(!connected);
+    CHECK(server.requests() == 1);
+    CHECK(ms < kBoundMs);
+}
+
+// The server answers the prewarm, then hangs on a background request
+// (full 2s timeout).  The aborted request is not the server's fault:
+// the link stays up and the breaker does not move.
+void testCancelDuringRequest() {
+    TestServer server([](const std::string& line) -> const char* {
+        return line.rfind("GET /api/ping ", 0) == 0 ? TestServer::kOk : nullptr;
+    });
+    ServerLink link;
+    link.setEndpoint("127.0.0.1", server.port(), Transport::Http);
+    CHECK(link.ensureConnected());
+
+    int status = 0;
+    double ms = cancelDuring(link, [&] {
+        status = link.post("/api/plugin/stats", "{}", "application/json", nullptr,
+                           RequestKind::Background);
+    });
+    std::printf("cancel during request: returned after %.1f ms\n", ms);
+    CHECK(status == -1);
+    CHECK(ms < kBoundMs);
+    CHECK(link.isUp());
+    CHECK(link.counters.breakerTrips == 0);
+
+    // Cancelled sends fail at once until resume().
+    auto start = clock_type::now();
+    CHECK(link.post("/api/deck/batch", "{}", "application/json") == -1);
+    CHECK(elapsedMs(start) < kBoundMs);
+    link.resume();
+    CHECK(link.ensureConnected());
+}
+
+} // namespace
+
+int main() {
+    testCancelDuringConnect();
+    testCancelDuringRequest();
+    return failures();
+}
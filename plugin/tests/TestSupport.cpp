@@ -0,0 +1,107 @@
+//////////////////////////////////////////////////////////////////////////
+// TestSupport.cpp – loopback HTTP server for the plugin tests
+//////////////////////////////////////////////////////////////////////////
+
+#include "TestSupport.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
+
+namespace {
+
+// Waits up to timeoutMs for fd to become readable.
+bool readable(int fd, int timeoutMs) {
+    pollfd p{fd, POLLIN, 0};
+    return ::poll(&p, 1, timeoutMs) > 0;
+}
+
+// Value of the Content-Length header in a request head, 0 if absent.
+size_t contentLength(const std::string& head) {
+    static const char kName[] = "\r\ncontent-length:";
+    for (size_t i = 0; i + sizeof kName - 1 <= head.size(); ++i) {
+        if (::strncasecmp(head.c_str() + i, kName, sizeof kName - 1) == 0)
+            return std::strtoul(head.c_str() + i + sizeof kName - 1, nullptr, 10);
+    }
+    return 0;
+}
+
+} // namespace
+
+TestServer::TestServer(Handler handler) : handler_(std::move(handler)) {
+    std::signal(SIGPIPE, SIG_IGN);  // a reply to a client that gave up
+
+    listen_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    ::setsockopt(listen_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+    sockaddr_in addr{};
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t len = sizeof addr;
+    if (::bind(listen_, reinterpret_cast<sockaddr*>(&addr), len) != 0 ||
+        ::listen(listen_, 16) != 0 ||
+        ::getsockname(listen_, reinterpret_cast<sockaddr*>(&addr), &len) != 0) {
+        std::perror("TestServer");
+        std::abort();
+    }
+    port_ = ntohs(addr.sin_port);
+    acceptThread_ = std::thread(&TestServer::acceptLoop, this);
+}
+
+TestServer::~TestServer() {
+    stop_ = true;
+    acceptThread_.join();
+    for (auto& t : threads_) t.join();
+    ::close(listen_);
+}
+
+std::vector<std::string> TestServer::received() const {
+    std::lock_guard<std::mutex> lock(mu_);
+    return received_;
+}
+
+void TestServer::acceptLoop() {
+    while (!stop_) {
+        if (!readable(listen_, kPollMs)) continue;
+        int fd = ::accept(listen_, nullptr, nullptr);
+        if (fd < 0) continue;
+        std::lock_guard<std::mutex> lock(mu_);
+        threads_.emplace_back(&TestServer::serve, this, fd);
+    }
+}
+
+// Reads requests off one keep-alive connection until the client closes
+// it or the server stops.
+void TestServer::serve(int fd) {
+    std::string buf;
+    char chunk[4096];
+    while (!stop_) {
+        size_t headEnd = buf.find("\r\n\r\n");
+        if (headEnd != std::string::npos) {
+            size_t total = headEnd + 4 + contentLength(buf.substr(0, headEnd + 2));
+            if (buf.size() >= total) {
+                std::string line = buf.substr(0, buf.find("\r\n"));
+                {
+                    std::lock_guard<std::mutex> lock(mu_);
+                    received_.push_back(line + ' ' + buf.substr(headEnd + 4, total - headEnd - 4));
+                }
+                buf.erase(0, total);
+                ++requests_;
+                if (const char* reply = handler_(line))
+                    ::send(fd, reply, std::strlen(reply), 0);
+                continue;
+            }
+        }
+        if (!readable(fd, kPollMs)) continue;
+        ssize_t n = ::recv(fd, chunk, sizeof chunk, 0);
+        if (n <= 0) break;
+        buf.append(chunk, static_cast<size_t>(n));
+    }
+    ::close(fd);
+}
@@ -0,0 +1,81 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// TestSupport – checks and a loopback HTTP server for the plugin tests
+//
+// Each test is a plain executable run by ctest: CHECK() reports a failed
+// condition and the test's main returns failures() as its exit code.
+//
+// TestServer listens on 127.0.0.1 (any free port) and answers every
+// request it reads through a handler, which may also leave it
+// unanswered, like a server that hangs.  It keeps what it received for
+// the checks.  POSIX sockets only: the tests run on Linux and macOS.
+//////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+#define CHECK(cond)                                                          \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,      \
+                         __LINE__, #cond);                                   \
+            ++failures();                                                    \
+        }                                                                    \
+    } while (0)
+
+// Milliseconds since start.
+inline double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+class TestServer {
+public:
+    // Called on a connection thread with each request line, e.g.
+    // "POST /api/deck/batch HTTP/1.1".  Returns the whole response, or
+    // nullptr to never answer it (the connection stays open).
+    using Handler = std::function<const char*(const std::string& requestLine)>;
+
+    explicit TestServer(Handler handler);
+    ~TestServer();
+
+    TestServer(const TestServer&) = delete;
+    TestServer& operator=(const TestServer&) = delete;
+
+    std::string port() const { return std::to_string(port_); }
+    int requests() const { return requests_; }
+
+    // Every request so far, in arrival order, as "<request line> <body>".
+    std::vector<std::string> received() const;
+
+    // Responses for handlers.
+    static constexpr char kOk[]        = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+    static constexpr char kNoContent[] = "HTTP/1.1 204 No Content\r\n\r\n";
+
+private:
+    void acceptLoop();
+    void serve(int fd);
+
+    static constexpr int kPollMs = 20;  // how often blocked threads check stop_
+
+    Handler           handler_;
+    int               listen_ = -1;
+    int               port_ = 0;
+    std::atomic<bool> stop_{false};
+    std::atomic<int>  requests_{0};
+    std::thread       acceptThread_;
+    mutable std::mutex mu_;  // threads_, received_
+    std::vector<std::thread> threads_;
+    std::vector<std::string> received_;
+};
@@ -0,0 +1,19 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// Stand-in for the VirtualDJ 8 SDK's vdjDsp8.h (see vdjPlugin8.h here)
+//////////////////////////////////////////////////////////////////////////
+
+#include "vdjPlugin8.h"
+
+class IVdjPluginDsp8 : public IVdjPlugin8 {
+public:
+    virtual HRESULT VDJ_API OnStart() { return S_OK; }
+    virtual HRESULT VDJ_API OnStop() { return S_OK; }
+    virtual HRESULT VDJ_API OnProcessSamples(float* buffer, int nb) = 0;
+
+    int    SampleRate = 44100;
+    int    SongBpm = 0;
+    double SongPosBeats = 0.0;
+};
+
+static const GUID IID_IVdjPluginDsp8 = {1, 0, 0, {0}};
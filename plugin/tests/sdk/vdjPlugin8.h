@@ -0,0 +1,90 @@
+#pragma once
+//////////////////////////////////////////////////////////////////////////
+// Stand-in for the VirtualDJ 8 SDK's vdjPlugin8.h, for the plugin tests
+//
+// The SDK is not distributed with the repo and only targets Windows and
+// macOS.  This declares just what the plugin sources use, with the same
+// names and signatures, so the tests build on Linux without it.  The
+// plugin itself always builds against the real SDK.
+//////////////////////////////////////////////////////////////////////////
+
+typedef long          HRESULT;
+typedef unsigned long ULONG;
+typedef unsigned int  DWORD;
+
+#define S_OK       ((HRESULT)0)
+#define S_FALSE    ((HRESULT)1)
+#define E_NOTIMPL  ((HRESULT)0x80004001L)
+#define E_FAIL     ((HRESULT)0x80004005L)
+#define CLASS_E_CLASSNOTAVAILABLE ((HRESULT)0x80040111L)
+#define NO_ERROR   0
+
+#define VDJ_EXPORT extern "C" __attribute__((visibility("default")))
+#define VDJ_API
+#define VDJ_BITMAP char*
+
+struct GUID {
+    unsigned long  Data1;
+    unsigned short Data2, Data3;
+    unsigned char  Data4[8];
+};
+
+struct TVdjPluginInfo8 {
+    const char* PluginName;
+    const char* Author;
+    const char* Description;
+    const char* Version;
+    VDJ_BITMAP  Bitmap;
+    DWORD       Flags;
+};
+
+// Parameter types passed to DeclareParameter().
+enum {
+    VDJPARAM_BUTTON = 0,
+    VDJPARAM_SLIDER = 1,
+    VDJPARAM_SWITCH = 2,
+    VDJPARAM_STRING = 3,
+};
+
+// The host side: what a test's fake host implements.
+class IVdjCallbacks8 {
+public:
+    virtual ~IVdjCallbacks8() {}
+    virtual HRESULT SendCommand(const char* command) = 0;
+    virtual HRESULT GetInfo(const char* command, double* result) = 0;
+    virtual HRESULT GetStringInfo(const char* command, char* result, int size) = 0;
+    virtual HRESULT DeclareParameter(void* parameter, int type, int id, const char* name,
+                                     const char* shortName, float defaultValue) = 0;
+};
+
+class IVdjPlugin8 {
+public:
+    virtual HRESULT VDJ_API OnLoad() { return S_OK; }
+    virtual HRESULT VDJ_API OnGetPluginInfo(TVdjPluginInfo8*) { return E_NOTIMPL; }
+    virtual ULONG   VDJ_API Release() { delete this; return S_OK; }
+    virtual ~IVdjPlugin8() {}
+    virtual HRESULT VDJ_API OnParameter(int) { return S_OK; }
+    virtual HRESULT VDJ_API OnGetParameterString(int, char*, int) { return E_NOTIMPL; }
+
+    HRESULT SendCommand(const char* c) { return cb->SendCommand(c); }
+    HRESULT GetInfo(const char* c, double* r) { return cb->GetInfo(c, r); }
+    HRESULT GetStringInfo(const char* c, char* r, int s) { return cb->GetStringInfo(c, r, s); }
+
+    HRESULT DeclareParameterButton(int* p, int id, const char* name, const char* shortName) {
+        return cb->DeclareParameter(p, VDJPARAM_BUTTON, id, name, shortName, 0);
+    }
+    HRESULT DeclareParameterSlider(float* p, int id, const char* name, const char* shortName, float def) {
+        return cb->DeclareParameter(p, VDJPARAM_SLIDER, id, name, shortName, def);
+    }
+    HRESULT DeclareParameterSwitch(int* p, int id, const char* name, const char* shortName, bool def) {
+        return cb->DeclareParameter(p, VDJPARAM_SWITCH, id, name, shortName, def ? 1.0f : 0.0f);
+    }
+    HRESULT DeclareParameterString(char* p, int id, const char* name, const char* shortName, int size) {
+        return cb->DeclareParameter(p, VDJPARAM_STRING, id, name, shortName, static_cast<float>(size));
+    }
+
+    void*           hInstance = nullptr;
+    IVdjCallbacks8* cb = nullptr;
+};
+
+static const GUID CLSID_VdjPlugin8 = {0, 0, 0, {0}};
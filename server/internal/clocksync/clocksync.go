@@ -0,0 +1,231 @@
+// Package clocksync estimates the offset and drift between the plugin's
+// steady clock and the server's, so deck updates can be placed on the
+// server timeline by when they were captured rather than when they
+// arrived.
+//
+// The plugin runs an NTP-style exchange: it stamps t0 when sending a
+// request, the server stamps t1 on receipt and t2 before replying, and
+// the plugin stamps t3 on the reply. The plugin reports (t0, t3) with
+// its next request. Each sample gives
+//
+//	offset = ((t1 - t0) + (t2 - t3)) / 2   (server minus plugin)
+//	delay  = (t3 - t0) - (t2 - t1)          (network round trip)
+//
+// As in NTP's clock filter, the sample with the smallest delay in a
+// short window is trusted (it saw the least queueing); drift is the
+// least-squares slope of those picks over a longer history.
+package clocksync
+
+import (
+	"math"
+	"sync"
+	"time"
+)
+
+// base anchors the server's monotonic microsecond clock.
+var base = time.Now()
+
+// Now is the server clock in microseconds, monotonic.
+func Now() int64 {
+	return time.Since(base).Microseconds()
+}
+
+// Time converts a server clock reading back to a time.Time.
+func Time(us int64) time.Time {
+	return base.Add(time.Duration(us) * time.Microsecond)
+}
+
+const (
+	filterSize  = 8          // samples the min-delay pick is made from
+	historySize = 32         // picks the drift is fitted over
+	minDriftUs  = 10_000_000 // history span needed before drift is used
+	maxDriftPPM = 500.0      // beyond this the fit is noise, not a clock
+	resetUs     = 1_000_000  // an offset jump this large restarts the estimate
+	staleUs     = 60_000_000 // no samples for this long: not synced
+	transitGain = 1.0 / 16   // EWMA weight of one transit sample
+)
+
+// Sample is one completed exchange, all in microseconds: t0 and t3 on
+// the plugin clock, t1 and t2 on the server clock.
+type Sample struct {
+	T0, T1, T2, T3 int64
+}
+
+func (s Sample) offset() float64 {
+	return float64((s.T1-s.T0)+(s.T2-s.T3)) / 2
+}
+
+func (s Sample) delay() int64 {
+	return (s.T3 - s.T0) - (s.T2 - s.T1)
+}
+
+type pick struct {
+	at     float64 // plugin time of the sample (midpoint of t0, t3)
+	offset float64
+}
+
+// Stats describe the current estimate, for the dashboard.
+type Stats struct {
+	Synced   bool    `json:"synced"`
+	OffsetUs int64   `json:"offsetUs"` // server minus plugin clock, now
+	DriftPPM float64 `json:"driftPpm"`
+	JitterUs int64   `json:"jitterUs"` // RMS spread of offsets in the filter window
+	DelayUs  int64   `json:"delayUs"`  // round trip of the trusted sample
+	Samples  uint64  `json:"samples"`
+	Resets   uint64  `json:"resets"`
+
+	// Capture-to-arrival time of deck updates on the server timeline,
+	// i.e. sender queueing plus network, less the output latency the
+	// plugin adds while it stamps by audio: smoothed mean and mean
+	// deviation.
+	TransitUs       int64 `json:"transitUs"`
+	TransitJitterUs int64 `json:"transitJitterUs"`
+}
+
+// Estimator tracks one plugin's clock. Safe for concurrent use.
+type Estimator struct {
+	mu      sync.Mutex
+	window  []Sample
+	history []pick
+	current pick    // trusted offset at its plugin time
+	drift   float64 // µs per µs (ppm / 1e6)
+	lastAt  int64   // server time of the latest sample
+	stats   Stats
+
+	transit, transitDev float64
+	haveTransit         bool
+}
+
+// New returns an empty estimator.
+func New() *Estimator {
+	return &Estimator{}
+}
+
+// Add folds in a completed exchange. Samples with a negative delay
+// (clock stepped mid-exchange) are ignored.
+func (e *Estimator) Add(s Sample) {
+	if s.delay() < 0 || s.T3 < s.T0 {
+		return
+	}
+	e.mu.Lock()
+	defer e.mu.Unlock()
+
+	// A plugin host reboot or clock step: start over.
+	if len(e.window) > 0 && math.Abs(s.offset()-e.offsetAt(float64(s.T3))) > resetUs {
+		e.window = e.window[:0]
+		e.history = e.history[:0]
+		e.drift = 0
+		e.stats.Resets++
+	}
+
+	e.window = append(e.window, s)
+	if len(e.window) > filterSize {
+		e.window = e.window[1:]
+	}
+	e.stats.Samples++
+	e.lastAt = s.T2
+
+	best := e.window[0]
+	for _, w := range e.window[1:] {
+		if w.delay() < best.delay() {
+			best = w
+		}
+	}
+	p := pick{at: float64(best.T0+best.T3) / 2, offset: best.offset()}
+	if len(e.history) == 0 || e.history[len(e.history)-1] != p {
+		e.history = append(e.history, p)
+		if len(e.history) > historySize {
+			e.history = e.history[1:]
+		}
+	}
+	e.current = p
+	e.fitDrift()
+
+	var sq float64
+	for _, w := range e.window {
+		d := w.offset() - p.offset
+		sq += d * d
+	}
+	e.stats.JitterUs = int64(math.Sqrt(sq / float64(len(e.window))))
+	e.stats.DelayUs = best.delay()
+	e.stats.DriftPPM = e.drift * 1e6
+}
+
+// fitDrift sets drift to the least-squares slope of offset over plugin
+// time once the history spans long enough to tell drift from jitter.
+func (e *Estimator) fitDrift() {
+	n := float64(len(e.history))
+	if n < 3 || e.history[len(e.history)-1].at-e.history[0].at < minDriftUs {
+		e.drift = 0
+		return
+	}
+	var mx, my float64
+	for _, p := range e.history {
+		mx += p.at
+		my += p.offset
+	}
+	mx /= n
+	my /= n
+	var sxy, sxx float64
+	for _, p := range e.history {
+		sxy += (p.at - mx) * (p.offset - my)
+		sxx += (p.at - mx) * (p.at - mx)
+	}
+	if sxx == 0 {
+		return
+	}
+	slope := sxy / sxx
+	if math.Abs(slope*1e6) > maxDriftPPM {
+		slope = 0
+	}
+	e.drift = slope
+}
+
+func (e *Estimator) offsetAt(pluginUs float64) float64 {
+	return e.current.offset + e.drift*(pluginUs-e.current.at)
+}
+
+func (e *Estimator) synced() bool {
+	return len(e.window) > 0 && Now()-e.lastAt < staleUs
+}
+
+// ToServer maps a plugin capture time onto the server clock. ok is
+// false until a sample has been taken (or after a long silence).
+func (e *Estimator) ToServer(pluginUs int64) (serverUs int64, ok bool) {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+	if !e.synced() {
+		return 0, false
+	}
+	return pluginUs + int64(math.Round(e.offsetAt(float64(pluginUs)))), true
+}
+
+// ObserveTransit records how long an update took from capture to
+// arrival (both on the server clock).
+func (e *Estimator) ObserveTransit(us int64) {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+	v := float64(us)
+	if !e.haveTransit {
+		e.transit, e.transitDev, e.haveTransit = v, v/2, true
+	} else {
+		e.transitDev += transitGain * (math.Abs(v-e.transit) - e.transitDev)
+		e.transit += transitGain * (v - e.transit)
+	}
+	e.stats.TransitUs = int64(e.transit)
+	e.stats.TransitJitterUs = int64(e.transitDev)
+}
+
+// Stats returns the current estimate.
+func (e *Estimator) Stats() Stats {
+	e.mu.Lock()
+	defer e.mu.Unlock()
+	s := e.stats
+	s.Synced = e.synced()
+	if len(e.window) > 0 {
+		// Offset as of now, extrapolated along the drift.
+		last := e.window[len(e.window)-1]
+		s.OffsetUs = int64(math.Round(e.offsetAt(float64(last.T3 + (Now() - last.T2)))))
+	}
+	return s
+}
@@ -12,14 +12,19 @@ import (
 	"path/filepath"
 	"strconv"
 	"sync"
+	"sync/atomic"
 	"time"
 
+	"github.com/jota2rz/vdj-video-sync/server/internal/clocksync"
 	"github.com/jota2rz/vdj-video-sync/server/internal/config"
 	"github.com/jota2rz/vdj-video-sync/server/internal/models"
 	"github.com/jota2rz/vdj-video-sync/server/internal/overlay"
+	"github.com/jota2rz/vdj-video-sync/server/internal/shm"
 	"github.com/jota2rz/vdj-video-sync/server/internal/sse"
 	"github.com/jota2rz/vdj-video-sync/server/internal/transitions"
+	"github.com/jota2rz/vdj-video-sync/server/internal/udp"
 	"github.com/jota2rz/vdj-video-sync/server/internal/video"
+	"github.com/jota2rz/vdj-video-sync/server/internal/wsock"
 	"github.com/jota2rz/vdj-video-sync/server/templates/pages"
 )
 
@@ -31,6 +36,15 @@ type Handlers struct {
 	transitionMatcher *video.Matcher
 	transitions       *transitions.Store
 
+	// Serialises deck-state application so a batch from one plugin tick
+	// is applied as a unit, never interleaved with another update.
+	deckUpdateMu sync.Mutex
+
+	// Full state per deck that plugin delta records apply on top of,
+	// with the track of the snapshot it came from. Protected by
+	// deckUpdateMu.
+	pluginDecks [maxDecks + 1]pluginDeck
+
 	// Logging state: track last-logged values and times per deck.
 	// Protected by logMu since HandleDeckUpdate, HandleForceVideo, and
 	// HandleVideoEnded can run concurrently.
@@ -90,6 +104,54 @@ type Handlers struct {
 	// Cached overlay-elements SSE event for new client sync
 	overlayCacheMu sync.RWMutex
 	overlayCache   []byte
+
+	// Connected plugin streams (WebSocket transport), used to push
+	// control messages back to the plugin.
+	pluginConnsMu sync.Mutex
+	pluginConns   map[*wsock.Conn]bool
+
+	// Latest sender counters reported by the VDJ plugin.
+	pluginStatsMu sync.RWMutex
+	pluginStats   json.RawMessage
+	pluginStatsAt time.Time
+
+	// Deck count of the plugin host's layout, from the "decks" field of
+	// its stats (0 = not reported yet).
+	pluginDeckCount atomic.Int32
+
+	// Counters of the UDP listener, if one is running. Set once at
+	// startup before serving.
+	udpStats func() udp.Stats
+
+	// Counters of the shared-memory ring reader, if one is running. Set
+	// once at startup before serving.
+	shmStats func() shm.Stats
+
+	// Plugin-to-server clock estimate, fed by /api/clock exchanges, used
+	// to place deck updates on the server timeline by capture time.
+	clock *clocksync.Estimator
+
+	// Server-side stamps of the last /api/clock reply, completed into a
+	// sample when the plugin reports its own stamps for it.
+	clockMu   sync.Mutex
+	clockLast clockExchange
+
+	// Verbs the plugin polls for overlay elements beyond DeckState
+	// (derived from the enabled elements), the latest value of each and
+	// the cached verb-values SSE event for new client sync.
+	subsMu     sync.Mutex
+	subs       models.SubscriptionList
+	verbValues map[int]map[string]string // deck (0 = global) → verb → text
+	verbCache  []byte
+
+	// Signalled (without blocking) when activeDeck changes; a goroutine
+	// started in New tells the plugin, off the deck update path.
+	videoDeckCh chan struct{}
+}
+
+// clockExchange is the server half of one clock exchange.
+type clockExchange struct {
+	t0, t1, t2 int64
 }
 
 // deckVideoSync tracks video playback position for match levels 2+.
@@ -119,6 +181,15 @@ type transitionPoolEntry struct {
 
 // New creates a Handlers instance.
 func New(cfg *config.Config, hub *sse.Hub, matcher *video.Matcher, transitionMatcher *video.Matcher, ts *transitions.Store, os *overlay.Store) *Handlers {
+	h := newHandlers(cfg, hub, matcher, transitionMatcher, ts, os)
+	h.refreshSubscriptions()
+	go h.pushVideoDeck()
+	return h
+}
+
+// newHandlers returns the initial state, without reading the stores or
+// starting the video deck push; the handler tests start from here.
+func newHandlers(cfg *config.Config, hub *sse.Hub, matcher *video.Matcher, transitionMatcher *video.Matcher, ts *transitions.Store, os *overlay.Store) *Handlers {
 	return &Handlers{
 		cfg:               cfg,
 		hub:               hub,
@@ -136,6 +207,10 @@ func New(cfg *config.Config, hub *sse.Hub, matcher *video.Matcher, transitionMat
 		forcedVideo:       make(map[int]*models.VideoFile),
 		forcedFilename:    make(map[int]string),
 		videoSync:         make(map[int]*deckVideoSync),
+		pluginConns:       make(map[*wsock.Conn]bool),
+		clock:             clocksync.New(),
+		verbValues:        make(map[int]map[string]string),
+		videoDeckCh:       make(chan struct{}, 1),
 	}
 }
 
@@ -209,6 +284,16 @@ func (h *Handlers) SetAnalysing(v bool) {
 	h.analysing = v
 	h.analysingMu.Unlock()
 
+	// Plugin frames are ignored while analysing, so deltas may have been
+	// missed: the next one after analysis triggers a resync.
+	if !v {
+		h.deckUpdateMu.Lock()
+		for d := range h.pluginDecks {
+			h.pluginDecks[d].valid = false
+		}
+		h.deckUpdateMu.Unlock()
+	}
+
 	status := "running"
 	if !v {
 		status = "done"
@@ -224,8 +309,40 @@ func (h *Handlers) SetAnalysing(v bool) {
 	h.hub.Broadcast("analysis-status", data)
 }
 
-// maxDecks is the maximum number of decks this application supports.
-const maxDecks = 4
+// maxDecks is the most decks a plugin can report (its kMaxDecks).
+// Until one reports its host's layout, defaultDecks are accepted.
+// maxBatchBytes bounds a /api/deck/batch body: the plugin's largest
+// frame, every deck a full record of worst-case text.
+const (
+	maxDecks      = 8
+	defaultDecks  = 4
+	maxBatchBytes = models.MaxFrameOverhead + maxDecks*models.MaxDeckRecordBytes
+)
+
+// readPluginBody reads a plugin request body of at most limit bytes.
+// A larger one is answered 413 rather than cut short into a decode
+// error, so the plugin sees why it was refused.
+func readPluginBody(w http.ResponseWriter, r *http.Request, limit int) ([]byte, bool) {
+	body, err := io.ReadAll(io.LimitReader(r.Body, int64(limit)+1))
+	if err != nil {
+		http.Error(w, "bad request", http.StatusBadRequest)
+		return nil, false
+	}
+	if len(body) > limit {
+		http.Error(w, "frame too large", http.StatusRequestEntityTooLarge)
+		return nil, false
+	}
+	return body, true
+}
+
+// deckCount returns how many decks the plugin last reported (see
+// HandlePluginStats); deck numbers above it are rejected.
+func (h *Handlers) deckCount() int {
+	if n := int(h.pluginDeckCount.Load()); n > 0 {
+		return n
+	}
+	return defaultDecks
+}
 
 // HandleDeckUpdate receives deck state from the VDJ plugin.
 func (h *Handlers) HandleDeckUpdate(w http.ResponseWriter, r *http.Request) {
@@ -239,9 +356,8 @@ func (h *Handlers) HandleDeckUpdate(w http.ResponseWriter, r *http.Request) {
 	}
 
 	defer r.Body.Close()
-	body, err := io.ReadAll(io.LimitReader(r.Body, 4096))
-	if err != nil {
-		http.Error(w, "bad request", http.StatusBadRequest)
+	body, ok := readPluginBody(w, r, models.MaxFrameOverhead+models.MaxDeckRecordBytes)
+	if !ok {
 		return
 	}
 
@@ -251,12 +367,253 @@ func (h *Handlers) HandleDeckUpdate(w http.ResponseWriter, r *http.Request) {
 		return
 	}
 
-	// Ignore invalid or out-of-range decks.
-	if state.Deck < 1 || state.Deck > maxDecks {
+	h.deckUpdateMu.Lock()
+	h.applyDeckState(state, time.Now())
+	h.deckUpdateMu.Unlock()
+	w.WriteHeader(http.StatusNoContent)
+}
+
+// HandleDeckBatch receives every changed deck from one plugin poll tick.
+// The whole frame is applied under deckUpdateMu with a single timestamp,
+// so all decks share one capture instant and no other update interleaves.
+func (h *Handlers) HandleDeckBatch(w http.ResponseWriter, r *http.Request) {
+	// Ignore VDJ updates while BPM analysis is running
+	h.analysingMu.Lock()
+	busy := h.analysing
+	h.analysingMu.Unlock()
+	if busy {
 		w.WriteHeader(http.StatusNoContent)
 		return
 	}
 
+	defer r.Body.Close()
+	body, ok := readPluginBody(w, r, maxBatchBytes)
+	if !ok {
+		return
+	}
+
+	var batch models.DeckBatch
+	var err error
+	if r.Header.Get("Content-Type") == models.WireContentType {
+		if batch, err = models.DecodeDeckBatch(body); err != nil {
+			http.Error(w, err.Error(), http.StatusBadRequest)
+			return
+		}
+	} else if err := json.Unmarshal(body, &batch); err != nil {
+		http.Error(w, "invalid json", http.StatusBadRequest)
+		return
+	}
+
+	if h.applyDeckBatch(batch) {
+		w.Header().Set("Content-Type", "application/json")
+		w.Write(resyncMessage)
+		return
+	}
+	w.WriteHeader(http.StatusNoContent)
+}
+
+// pluginDeck is the merged plugin state of one deck.
+type pluginDeck struct {
+	state models.DeckState
+	track uint32
+	valid bool
+}
+
+// resyncMessage asks the plugin to resend every deck as a snapshot. It
+// is the body of a /api/deck/batch response or a stream control push.
+var resyncMessage = []byte(`{"type":"resync"}`)
+
+// applyDeckBatch applies every deck of one plugin tick as a unit.
+// Delta records are merged into the deck's last snapshot; a delta whose
+// snapshot this server never saw (it restarted, or a frame was lost) is
+// skipped and true is returned so the caller requests a resync.
+func (h *Handlers) applyDeckBatch(batch models.DeckBatch) (resync bool) {
+	h.deckUpdateMu.Lock()
+	defer h.deckUpdateMu.Unlock()
+	now := h.captureTime(batch.CaptureUs)
+	for i := range batch.Decks {
+		rec := &batch.Decks[i]
+		if rec.Deck < 1 || rec.Deck > h.deckCount() {
+			continue
+		}
+		base := &h.pluginDecks[rec.Deck]
+		switch {
+		case rec.IsSnapshot():
+			*base = pluginDeck{state: rec.DeckState, track: rec.Track, valid: true}
+		case base.valid && rec.Track != 0 && rec.Track == base.track:
+			rec.MergeInto(&base.state)
+		default:
+			resync = true
+			continue
+		}
+		h.applyDeckState(base.state, now)
+	}
+	return resync
+}
+
+// maxCaptureAge bounds how far back a capture time may place an update.
+// Anything older is a stale estimate or a stuck sender, not transit.
+const maxCaptureAge = 2 * time.Second
+
+// maxCaptureLead bounds how far ahead of arrival a capture time may be.
+// While audio runs the plugin stamps deck reads with when the block is
+// heard, up to one device buffer after it was read.
+const maxCaptureLead = 500 * time.Millisecond
+
+// captureTime maps a batch's plugin capture time onto the server clock.
+// Without a clock estimate (or a capture time) it is the arrival time;
+// a mapped time implausibly far ahead or behind is clamped to arrival.
+func (h *Handlers) captureTime(captureUs int64) time.Time {
+	arrival := clocksync.Now()
+	if captureUs == 0 {
+		return clocksync.Time(arrival)
+	}
+	at, ok := h.clock.ToServer(captureUs)
+	if !ok || at-arrival > maxCaptureLead.Microseconds() || arrival-at > maxCaptureAge.Microseconds() {
+		return clocksync.Time(arrival)
+	}
+	h.clock.ObserveTransit(arrival - at)
+	return clocksync.Time(at)
+}
+
+// HandleClock is the server half of the plugin's NTP-style clock
+// exchange. The reply carries t1 (request received) and t2 (reply sent)
+// on the server clock. The plugin passes its own send and receive times
+// of the previous exchange as pt0/pt3, plus t0 of this one, which the
+// server echoes back to pair them up.
+func (h *Handlers) HandleClock(w http.ResponseWriter, r *http.Request) {
+	t1 := clocksync.Now()
+	q := r.URL.Query()
+	t0, _ := strconv.ParseInt(q.Get("t0"), 10, 64)
+	pt0, _ := strconv.ParseInt(q.Get("pt0"), 10, 64)
+	pt3, _ := strconv.ParseInt(q.Get("pt3"), 10, 64)
+
+	h.clockMu.Lock()
+	if prev := h.clockLast; pt0 != 0 && pt0 == prev.t0 {
+		h.clock.Add(clocksync.Sample{T0: pt0, T1: prev.t1, T2: prev.t2, T3: pt3})
+	}
+	w.Header().Set("Content-Type", "application/json")
+	t2 := clocksync.Now()
+	h.clockLast = clockExchange{t0: t0, t1: t1, t2: t2}
+	h.clockMu.Unlock()
+
+	fmt.Fprintf(w, `{"t0":%d,"t1":%d,"t2":%d}`, t0, t1, t2)
+}
+
+// pluginReadTimeout is how long a plugin stream may stay silent. The
+// plugin pings every 5 seconds, so this only trips on a dead peer.
+const pluginReadTimeout = 30 * time.Second
+
+// HandleDeckStream upgrades to a WebSocket over which the plugin streams
+// the same frames it would POST to /api/deck/batch (JSON as text
+// messages, the binary wire format as binary ones), without waiting for
+// replies. The connection also carries control messages back to the
+// plugin (see PushPluginControl).
+func (h *Handlers) HandleDeckStream(w http.ResponseWriter, r *http.Request) {
+	conn, err := wsock.Upgrade(w, r)
+	if err != nil {
+		slog.Warn("plugin stream upgrade failed", "error", err)
+		return
+	}
+	defer conn.Close()
+
+	h.pluginConnsMu.Lock()
+	h.pluginConns[conn] = true
+	h.pluginConnsMu.Unlock()
+	defer func() {
+		h.pluginConnsMu.Lock()
+		delete(h.pluginConns, conn)
+		h.pluginConnsMu.Unlock()
+	}()
+
+	slog.Info("plugin stream connected", "remote", r.RemoteAddr)
+	hello, _ := json.Marshal(map[string]any{"type": "hello", "maxDecks": maxDecks})
+	conn.WriteMessage(wsock.OpText, hello)
+	conn.WriteMessage(wsock.OpText, videoDeckMessage(h.videoDeck()))
+
+	for {
+		conn.SetReadDeadline(time.Now().Add(pluginReadTimeout))
+		op, payload, err := conn.ReadMessage()
+		if err != nil {
+			slog.Info("plugin stream disconnected", "remote", r.RemoteAddr, "reason", err)
+			return
+		}
+		var batch models.DeckBatch
+		switch op {
+		case wsock.OpText:
+			err = json.Unmarshal(payload, &batch)
+		case wsock.OpBinary:
+			batch, err = models.DecodeDeckBatch(payload)
+		default:
+			continue
+		}
+		if err != nil {
+			slog.Warn("plugin stream: invalid frame", "error", err)
+			continue
+		}
+
+		if h.applyPluginFrame(batch) {
+			conn.WriteMessage(wsock.OpText, resyncMessage)
+		}
+	}
+}
+
+// ApplyPluginFrame applies a frame that arrived outside an HTTP request
+// (a UDP datagram), ignoring it during BPM analysis. Datagrams carry
+// snapshots only, so there is never a resync to request.
+func (h *Handlers) ApplyPluginFrame(batch models.DeckBatch) {
+	h.applyPluginFrame(batch)
+}
+
+// applyPluginFrame is ApplyPluginFrame reporting whether the plugin
+// should be asked to resync.
+func (h *Handlers) applyPluginFrame(batch models.DeckBatch) bool {
+	h.analysingMu.Lock()
+	busy := h.analysing
+	h.analysingMu.Unlock()
+	if busy {
+		return false
+	}
+	return h.applyDeckBatch(batch)
+}
+
+// SetUDPStats registers the UDP listener's counters so they are served
+// with the plugin stats. Call before the server starts.
+func (h *Handlers) SetUDPStats(fn func() udp.Stats) {
+	h.udpStats = fn
+}
+
+// SetShmStats registers the shared-memory ring reader's counters so they
+// are served with the plugin stats. Call before the server starts.
+func (h *Handlers) SetShmStats(fn func() shm.Stats) {
+	h.shmStats = fn
+}
+
+// PushPluginControl sends a control message to every connected plugin
+// stream. Plugins on the HTTP transport do not receive pushes.
+func (h *Handlers) PushPluginControl(msg any) {
+	data, err := json.Marshal(msg)
+	if err != nil {
+		return
+	}
+	h.pluginConnsMu.Lock()
+	defer h.pluginConnsMu.Unlock()
+	for conn := range h.pluginConns {
+		if err := conn.WriteMessage(wsock.OpText, data); err != nil {
+			slog.Warn("plugin control push failed", "error", err)
+		}
+	}
+}
+
+// applyDeckState matches a video for one deck, advances its position
+// tracking to now, and broadcasts the resulting deck-update event.
+// Must be called with deckUpdateMu held.
+func (h *Handlers) applyDeckState(state models.DeckState, now time.Time) {
+	// Ignore invalid or out-of-range decks.
+	if state.Deck < 1 || state.Deck > h.deckCount() {
+		return
+	}
+
 	// Try to match a video for this deck (tiered fallback)
 	var matched *models.VideoFile
 
@@ -282,7 +639,6 @@ func (h *Handlers) HandleDeckUpdate(w http.ResponseWriter, r *http.Request) {
 	// ── Video position tracking for levels 2+ (cross-client sync) ──
 	var videoElapsedMs *float64
 	if matched != nil && matched.MatchLevel >= 2 {
-		now := time.Now()
 		h.videoSyncMu.Lock()
 		vs := h.videoSync[state.Deck]
 		if vs == nil {
@@ -299,9 +655,15 @@ func (h *Handlers) HandleDeckUpdate(w http.ResponseWriter, r *http.Request) {
 			vs.playing = false
 		}
 
-		// Accumulate elapsed time at previous rate (only while playing)
+		// Accumulate elapsed time at previous rate (only while playing).
+		// Capture times from different transports can arrive out of
+		// order; never integrate backwards.
+		at := now
+		if at.Before(vs.lastUpdate) {
+			at = vs.lastUpdate
+		}
 		if vs.playing && !vs.lastUpdate.IsZero() {
-			dt := now.Sub(vs.lastUpdate).Seconds() * 1000
+			dt := at.Sub(vs.lastUpdate).Seconds() * 1000
 			vs.accumulatedMs += dt * vs.lastRate
 		}
 
@@ -317,10 +679,15 @@ func (h *Handlers) HandleDeckUpdate(w http.ResponseWriter, r *http.Request) {
 		}
 
 		vs.lastRate = rate
-		vs.lastUpdate = now
+		vs.lastUpdate = at
 		vs.playing = state.IsPlaying
 
+		// The position is that of the capture instant; carry it to the
+		// broadcast instant so clients land where the audio is.
 		elapsed := vs.accumulatedMs
+		if vs.playing {
+			elapsed = max(0, elapsed+time.Since(at).Seconds()*1000*rate)
+		}
 		videoElapsedMs = &elapsed
 		h.videoSyncMu.Unlock()
 	}
@@ -333,7 +700,7 @@ func (h *Handlers) HandleDeckUpdate(w http.ResponseWriter, r *http.Request) {
 		VideoElapsedMs *float64          `json:"videoElapsedMs,omitempty"`
 	}{
 		DeckState:      state,
-		Timestamp:      time.Now(),
+		Timestamp:      now,
 		Video:          matched,
 		VideoElapsedMs: videoElapsedMs,
 	}
@@ -380,9 +747,221 @@ func (h *Handlers) HandleDeckUpdate(w http.ResponseWriter, r *http.Request) {
 
 	h.lastLogState[state.Deck] = state
 	h.logMu.Unlock()
+}
+
+// HandlePing answers the plugin's connection prewarm. It does no work so
+// the measured time is pure connection setup plus one round trip.
+// Accept-Post tells the plugin which deck frame formats it may send.
+func (h *Handlers) HandlePing(w http.ResponseWriter, r *http.Request) {
+	w.Header().Set("Accept-Post", "application/json, "+models.WireContentType)
+	w.WriteHeader(http.StatusNoContent)
+}
+
+// HandlePluginStats receives the plugin's periodic sender counters.
+// The payload is an opaque JSON object kept as-is so new counters on the
+// plugin side need no server change. Only "decks", the host's deck
+// count, is read: it widens or narrows the accepted deck range. A
+// plugin's fan-out endpoints post the deck count alone, which does not
+// replace the last full report.
+func (h *Handlers) HandlePluginStats(w http.ResponseWriter, r *http.Request) {
+	defer r.Body.Close()
+	body, err := io.ReadAll(io.LimitReader(r.Body, 16384))
+	if err != nil {
+		http.Error(w, "bad request", http.StatusBadRequest)
+		return
+	}
+
+	var fields map[string]json.RawMessage
+	if err := json.Unmarshal(body, &fields); err != nil {
+		http.Error(w, "invalid json", http.StatusBadRequest)
+		return
+	}
+
+	var decks int32
+	if json.Unmarshal(fields["decks"], &decks) == nil && decks >= 1 && decks <= maxDecks {
+		h.pluginDeckCount.Store(decks)
+	}
+
+	if _, ok := fields["decks"]; !ok || len(fields) > 1 {
+		h.pluginStatsMu.Lock()
+		h.pluginStats = json.RawMessage(body)
+		h.pluginStatsAt = time.Now()
+		h.pluginStatsMu.Unlock()
+
+		slog.Debug("plugin stats", "stats", string(body))
+	}
+
+	// The reply announces the subscription version and the deck on
+	// screen, so plugins without a stream notice a change within one
+	// stats interval.
+	h.subsMu.Lock()
+	version := h.subs.Version
+	h.subsMu.Unlock()
+	w.Header().Set("Content-Type", "application/json")
+	fmt.Fprintf(w, `{"type":"status","version":%d,"videoDeck":%d}`, version, h.videoDeck())
+}
+
+// subscriptionsMessage tells the plugin the current subscription list
+// version; it fetches /api/plugin/subscriptions when its own differs.
+func subscriptionsMessage(version uint32) []byte {
+	return fmt.Appendf(nil, `{"type":"subscriptions","version":%d}`, version)
+}
+
+// refreshSubscriptions re-derives the plugin subscription list from the
+// overlay elements. On a change, connected plugin streams are told right
+// away and values of verbs no longer subscribed are dropped.
+func (h *Handlers) refreshSubscriptions() {
+	list, err := h.overlay.Subscriptions()
+	if err != nil {
+		slog.Error("overlay subscriptions", "error", err)
+		return
+	}
+
+	h.subsMu.Lock()
+	changed := list.Version != h.subs.Version
+	h.subs = list
+	pruned := false
+	for deck, values := range h.verbValues {
+		for verb := range values {
+			if !h.subscribedLocked(verb, deck) {
+				delete(values, verb)
+				pruned = true
+			}
+		}
+	}
+	if pruned {
+		h.broadcastVerbValuesLocked()
+	}
+	h.subsMu.Unlock()
+
+	if changed {
+		slog.Info("plugin subscriptions", "version", list.Version, "verbs", len(list.Verbs))
+		h.PushPluginControl(json.RawMessage(subscriptionsMessage(list.Version)))
+	}
+}
+
+// subscribedLocked reports whether the plugin may report verb for deck
+// (0 = global). Must be called with subsMu held.
+func (h *Handlers) subscribedLocked(verb string, deck int) bool {
+	scope := "deck"
+	if deck == 0 {
+		scope = "global"
+	}
+	for _, sub := range h.subs.Verbs {
+		if sub.Verb == verb && sub.Scope == scope {
+			return true
+		}
+	}
+	return false
+}
+
+// broadcastVerbValuesLocked sends every current subscribed value as one
+// verb-values event, {"global":{verb:text},"decks":{"1":{verb:text}}},
+// and caches it for new clients. Must be called with subsMu held.
+func (h *Handlers) broadcastVerbValuesLocked() {
+	event := struct {
+		Global map[string]string         `json:"global"`
+		Decks  map[int]map[string]string `json:"decks"`
+	}{
+		Global: h.verbValues[0],
+		Decks:  make(map[int]map[string]string),
+	}
+	if event.Global == nil {
+		event.Global = map[string]string{}
+	}
+	for deck, values := range h.verbValues {
+		if deck > 0 {
+			event.Decks[deck] = values
+		}
+	}
+	data, _ := json.Marshal(event)
+	h.verbCache = fmt.Appendf(nil, "event: verb-values\ndata: %s\n\n", data)
+	h.hub.Broadcast("verb-values", data)
+}
+
+// HandleGetSubscriptions returns the verbs the plugin should poll
+// besides DeckState, with their scope and interval.
+func (h *Handlers) HandleGetSubscriptions(w http.ResponseWriter, r *http.Request) {
+	h.subsMu.Lock()
+	list := h.subs
+	h.subsMu.Unlock()
+	w.Header().Set("Content-Type", "application/json")
+	json.NewEncoder(w).Encode(list)
+}
+
+// HandlePluginVerbs receives changed values of subscribed verbs. Values
+// of verbs that are not (or no longer) subscribed are ignored; an empty
+// value clears one (the deck was emptied).
+func (h *Handlers) HandlePluginVerbs(w http.ResponseWriter, r *http.Request) {
+	defer r.Body.Close()
+	var batch models.VerbValues
+	if err := json.NewDecoder(io.LimitReader(r.Body, 65536)).Decode(&batch); err != nil {
+		http.Error(w, "invalid json", http.StatusBadRequest)
+		return
+	}
+
+	h.subsMu.Lock()
+	changed := false
+	for _, v := range batch.Values {
+		if v.Deck < 0 || v.Deck > h.deckCount() || !h.subscribedLocked(v.Verb, v.Deck) {
+			continue
+		}
+		values := h.verbValues[v.Deck]
+		if values == nil {
+			values = make(map[string]string)
+			h.verbValues[v.Deck] = values
+		}
+		if old, ok := values[v.Verb]; ok && old == v.Value {
+			continue
+		}
+		if v.Value == "" {
+			delete(values, v.Verb)
+		} else {
+			values[v.Verb] = v.Value
+		}
+		changed = true
+	}
+	if changed {
+		h.broadcastVerbValuesLocked()
+	}
+	h.subsMu.Unlock()
 	w.WriteHeader(http.StatusNoContent)
 }
 
+// HandleGetPluginStats returns the latest plugin counters and when they
+// were received, plus the server's own UDP and shared-memory receive
+// counters when those readers are running and the plugin clock estimate.
+// Stats is null until the plugin has reported once.
+func (h *Handlers) HandleGetPluginStats(w http.ResponseWriter, r *http.Request) {
+	h.pluginStatsMu.RLock()
+	payload := struct {
+		ReceivedAt *time.Time      `json:"receivedAt,omitempty"`
+		Stats      json.RawMessage `json:"stats"`
+		UDP        *udp.Stats      `json:"udp,omitempty"`
+		Shm        *shm.Stats      `json:"shm,omitempty"`
+		Clock      clocksync.Stats `json:"clock"`
+	}{
+		Stats: h.pluginStats,
+		Clock: h.clock.Stats(),
+	}
+	if !h.pluginStatsAt.IsZero() {
+		at := h.pluginStatsAt
+		payload.ReceivedAt = &at
+	}
+	h.pluginStatsMu.RUnlock()
+	if h.udpStats != nil {
+		stats := h.udpStats()
+		payload.UDP = &stats
+	}
+	if h.shmStats != nil {
+		stats := h.shmStats()
+		payload.Shm = &stats
+	}
+
+	w.Header().Set("Content-Type", "application/json")
+	json.NewEncoder(w).Encode(payload)
+}
+
 // HandleForceVideo forces a specific video to be used for the current active
 // deck. Triggers a transition and immediately broadcasts the updated deck
 // state with the forced video. The override persists until the deck's song
@@ -498,8 +1077,8 @@ func (h *Handlers) HandleForceDeckVideo(w http.ResponseWriter, r *http.Request)
 		Path string `json:"path"`
 		Deck int    `json:"deck"`
 	}
-	if err := json.Unmarshal(body, &req); err != nil || req.Path == "" || req.Deck < 1 || req.Deck > maxDecks {
-		http.Error(w, "invalid json: path and deck (1-4) required", http.StatusBadRequest)
+	if err := json.Unmarshal(body, &req); err != nil || req.Path == "" || req.Deck < 1 || req.Deck > h.deckCount() {
+		http.Error(w, "invalid json: path and a known deck required", http.StatusBadRequest)
 		return
 	}
 
@@ -607,7 +1186,7 @@ func (h *Handlers) HandleVideoEnded(w http.ResponseWriter, r *http.Request) {
 		http.Error(w, "invalid json: deck required", http.StatusBadRequest)
 		return
 	}
-	if req.Deck > maxDecks {
+	if req.Deck > h.deckCount() {
 		http.Error(w, "deck out of range", http.StatusBadRequest)
 		return
 	}
@@ -735,6 +1314,10 @@ func (h *Handlers) checkActiveDeckChange(state models.DeckState, matched *models
 
 	prevDeck := h.activeDeck
 	h.activeDeck = bestDeck
+	select {
+	case h.videoDeckCh <- struct{}{}:
+	default: // a push is already pending; it reads the latest deck
+	}
 
 	if prevDeck == 0 && bestDeck != 0 {
 		// First deck became active — fill the pool so clients have
@@ -748,6 +1331,27 @@ func (h *Handlers) checkActiveDeckChange(state models.DeckState, matched *models
 	}
 }
 
+// videoDeck returns the deck whose video is on screen (0 = none).
+func (h *Handlers) videoDeck() int {
+	h.activeDeckMu.Lock()
+	defer h.activeDeckMu.Unlock()
+	return h.activeDeck
+}
+
+// videoDeckMessage tells the plugin which deck's video is on screen; it
+// spends most of its update budget on that deck.
+func videoDeckMessage(deck int) []byte {
+	return fmt.Appendf(nil, `{"type":"video","videoDeck":%d}`, deck)
+}
+
+// pushVideoDeck tells connected plugin streams about active deck changes
+// signalled on videoDeckCh. Runs for the life of the server.
+func (h *Handlers) pushVideoDeck() {
+	for range h.videoDeckCh {
+		h.PushPluginControl(json.RawMessage(videoDeckMessage(h.videoDeck())))
+	}
+}
+
 // pickRandomTransition picks a random transition video, excluding the given
 // paths to avoid putting duplicate videos in the pool.
 // Must be called with activeDeckMu held.
@@ -996,6 +1600,12 @@ func (h *Handlers) HandleSSE(w http.ResponseWriter, r *http.Request) {
 	}
 	h.overlayCacheMu.RUnlock()
 
+	h.subsMu.Lock()
+	if h.verbCache != nil {
+		w.Write(h.verbCache)
+	}
+	h.subsMu.Unlock()
+
 	flusher.Flush()
 
 	for {
@@ -1331,6 +1941,9 @@ func (h *Handlers) broadcastOverlayUpdated() {
 	h.overlayCacheMu.Unlock()
 
 	h.hub.Broadcast("overlay-updated", data)
+
+	// Elements bound to verbs may have come or gone.
+	h.refreshSubscriptions()
 }
 
 func (h *Handlers) HandleOverlay(w http.ResponseWriter, r *http.Request) {
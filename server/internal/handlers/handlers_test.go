@@ -0,0 +1,164 @@
+package handlers
+
+import (
+	"fmt"
+	"net/http"
+	"net/http/httptest"
+	"strings"
+	"testing"
+
+	"github.com/jota2rz/vdj-video-sync/server/internal/models"
+	"github.com/jota2rz/vdj-video-sync/server/internal/sse"
+	"github.com/jota2rz/vdj-video-sync/server/internal/video"
+)
+
+// newTestHandlers returns handlers with an empty video library and a
+// running hub, so deck updates apply and broadcast without a database.
+func newTestHandlers(t *testing.T) *Handlers {
+	t.Helper()
+	hub := sse.NewHub()
+	go hub.Run()
+	t.Cleanup(hub.Close)
+	matcher := video.NewMatcher(t.TempDir(), "/videos/", nil)
+	return newHandlers(nil, hub, matcher, matcher, nil, nil)
+}
+
+func post(handler http.HandlerFunc, path, body string) *httptest.ResponseRecorder {
+	w := httptest.NewRecorder()
+	handler(w, httptest.NewRequest(http.MethodPost, path, strings.NewReader(body)))
+	return w
+}
+
+// snapshot is a full JSON record of deck, with track.
+func snapshot(deck int, track uint32) string {
+	return fmt.Sprintf(`{"deck":%d,"track":%d,"isAudible":true,"isPlaying":true,"volume":1,`+
+		`"elapsedMs":0,"bpm":124,"filename":"a.mp4","pitch":100,"totalTimeMs":300000,`+
+		`"title":"","artist":""}`, deck, track)
+}
+
+// applied reports whether a deck update was broadcast for deck.
+func applied(h *Handlers, deck int) bool {
+	h.deckCacheMu.Lock()
+	defer h.deckCacheMu.Unlock()
+	_, ok := h.deckCache[deck]
+	return ok
+}
+
+func TestPluginStatsDeckCount(t *testing.T) {
+	h := newTestHandlers(t)
+	if got := h.deckCount(); got != defaultDecks {
+		t.Fatalf("deckCount before any stats = %d, want %d", got, defaultDecks)
+	}
+
+	for _, tc := range []struct {
+		body string
+		want int
+	}{
+		{`{"decks":6,"sender":{}}`, 6},
+		{`{"decks":0}`, 6},
+		{`{"decks":9}`, 6},
+		{`{"decks":"8"}`, 6},
+		{`{"sender":{}}`, 6},
+		{`{"decks":2}`, 2},
+		{`{"decks":8}`, 8},
+	} {
+		w := post(h.HandlePluginStats, "/api/plugin/stats", tc.body)
+		if w.Code != http.StatusOK {
+			t.Fatalf("%s: status %d, want 200", tc.body, w.Code)
+		}
+		if !strings.Contains(w.Body.String(), `"type":"status"`) {
+			t.Errorf("%s: reply %q is not a status message", tc.body, w.Body.String())
+		}
+		if got := h.deckCount(); got != tc.want {
+			t.Errorf("after %s: deckCount = %d, want %d", tc.body, got, tc.want)
+		}
+	}
+
+	if w := post(h.HandlePluginStats, "/api/plugin/stats", `{"decks":`); w.Code != http.StatusBadRequest {
+		t.Errorf("truncated stats: status %d, want 400", w.Code)
+	}
+
+	// The deck count alone (a fan-out endpoint) keeps the full report.
+	h.pluginStatsMu.Lock()
+	stats := string(h.pluginStats)
+	h.pluginStatsMu.Unlock()
+	if stats != `{"sender":{}}` {
+		t.Errorf("stored stats = %s, want the last full report", stats)
+	}
+}
+
+func TestDeckBatchDeckRange(t *testing.T) {
+	h := newTestHandlers(t)
+	batch := func(decks ...int) string {
+		records := make([]string, len(decks))
+		for i, d := range decks {
+			records[i] = snapshot(d, 1)
+		}
+		return `{"decks":[` + strings.Join(records, ",") + `]}`
+	}
+
+	// Default layout: deck 5 is dropped, the rest of the frame applies.
+	if w := post(h.HandleDeckBatch, "/api/deck/batch", batch(4, 5)); w.Code != http.StatusNoContent {
+		t.Fatalf("batch: status %d, want 204", w.Code)
+	}
+	if !applied(h, 4) || applied(h, 5) {
+		t.Errorf("default layout: deck 4 applied %v, deck 5 applied %v", applied(h, 4), applied(h, 5))
+	}
+
+	post(h.HandlePluginStats, "/api/plugin/stats", `{"decks":6}`)
+	post(h.HandleDeckBatch, "/api/deck/batch", batch(5, 6, 7))
+	if !applied(h, 5) || !applied(h, 6) || applied(h, 7) {
+		t.Errorf("6 decks: decks 5, 6, 7 applied %v, %v, %v", applied(h, 5), applied(h, 6), applied(h, 7))
+	}
+}
+
+func TestDeckBatchBodyLimit(t *testing.T) {
+	h := newTestHandlers(t)
+	frame := `{"decks":[]}`
+	fits := frame + strings.Repeat(" ", maxBatchBytes-len(frame))
+
+	if w := post(h.HandleDeckBatch, "/api/deck/batch", fits); w.Code != http.StatusNoContent {
+		t.Errorf("%d-byte batch: status %d, want 204", len(fits), w.Code)
+	}
+	if w := post(h.HandleDeckBatch, "/api/deck/batch", fits+" "); w.Code != http.StatusRequestEntityTooLarge {
+		t.Errorf("%d-byte batch: status %d, want 413", len(fits)+1, w.Code)
+	}
+
+	single := models.MaxFrameOverhead + models.MaxDeckRecordBytes
+	if w := post(h.HandleDeckUpdate, "/api/deck/update", strings.Repeat(" ", single+1)); w.Code != http.StatusRequestEntityTooLarge {
+		t.Errorf("%d-byte update: status %d, want 413", single+1, w.Code)
+	}
+}
+
+func TestDeckBatchResync(t *testing.T) {
+	h := newTestHandlers(t)
+	delta := `{"decks":[{"deck":1,"track":7,"volume":0.5}]}`
+
+	// No snapshot of deck 1 yet: the delta is skipped and a resync asked.
+	w := post(h.HandleDeckBatch, "/api/deck/batch", delta)
+	if w.Code != http.StatusOK || w.Body.String() != string(resyncMessage) {
+		t.Fatalf("delta before snapshot: %d %q, want 200 %s", w.Code, w.Body.String(), resyncMessage)
+	}
+	if applied(h, 1) {
+		t.Error("delta before snapshot was applied")
+	}
+
+	if w := post(h.HandleDeckBatch, "/api/deck/batch", `{"decks":[`+snapshot(1, 7)+`]}`); w.Code != http.StatusNoContent {
+		t.Fatalf("snapshot: status %d, want 204", w.Code)
+	}
+	if w := post(h.HandleDeckBatch, "/api/deck/batch", delta); w.Code != http.StatusNoContent {
+		t.Errorf("delta after snapshot: status %d, want 204", w.Code)
+	}
+	h.deckUpdateMu.Lock()
+	volume := h.pluginDecks[1].state.Volume
+	h.deckUpdateMu.Unlock()
+	if volume != 0.5 {
+		t.Errorf("volume after delta = %v, want 0.5", volume)
+	}
+
+	// A delta for another track needs that track's snapshot.
+	w = post(h.HandleDeckBatch, "/api/deck/batch", `{"decks":[{"deck":1,"track":8,"volume":0.2}]}`)
+	if w.Code != http.StatusOK || w.Body.String() != string(resyncMessage) {
+		t.Errorf("delta for a new track: %d %q, want 200 %s", w.Code, w.Body.String(), resyncMessage)
+	}
+}
@@ -1,5 +1,7 @@
 package models
 
+import "encoding/json"
+
 // DeckState represents the current state of a VirtualDJ deck,
 // received from the C++ plugin via HTTP POST.
 type DeckState struct {
@@ -16,6 +18,130 @@ type DeckState struct {
 	Artist      string  `json:"artist"`      // get_artist: song artist metadata
 }
 
+// Field bits of DeckRecord.Fields: which DeckState fields a record
+// carries. Deck, IsAudible and IsPlaying are always present.
+const (
+	FieldElapsed uint16 = 1 << iota
+	FieldTotalTime
+	FieldVolume
+	FieldBPM
+	FieldPitch
+	FieldFilename
+	FieldTitle
+	FieldArtist
+
+	FieldsAll uint16 = 1<<iota - 1 // a snapshot
+)
+
+// DeckRecord is one deck as sent by the plugin. A snapshot carries every
+// field; a delta carries only Fields and applies on top of the snapshot
+// with the same Track. Track 0 marks a record from a plugin without
+// deltas, which is always a snapshot.
+type DeckRecord struct {
+	DeckState
+	Track  uint32
+	Fields uint16
+}
+
+// IsSnapshot reports whether the record carries every field.
+func (r *DeckRecord) IsSnapshot() bool {
+	return r.Fields == FieldsAll
+}
+
+// MergeInto copies the fields the record carries into s.
+func (r *DeckRecord) MergeInto(s *DeckState) {
+	s.Deck = r.Deck
+	s.IsAudible = r.IsAudible
+	s.IsPlaying = r.IsPlaying
+	if r.Fields&FieldElapsed != 0 {
+		s.ElapsedMs = r.ElapsedMs
+	}
+	if r.Fields&FieldTotalTime != 0 {
+		s.TotalTimeMs = r.TotalTimeMs
+	}
+	if r.Fields&FieldVolume != 0 {
+		s.Volume = r.Volume
+	}
+	if r.Fields&FieldBPM != 0 {
+		s.BPM = r.BPM
+	}
+	if r.Fields&FieldPitch != 0 {
+		s.Pitch = r.Pitch
+	}
+	if r.Fields&FieldFilename != 0 {
+		s.Filename = r.Filename
+	}
+	if r.Fields&FieldTitle != 0 {
+		s.Title = r.Title
+	}
+	if r.Fields&FieldArtist != 0 {
+		s.Artist = r.Artist
+	}
+}
+
+// UnmarshalJSON decodes a JSON record, deriving Fields from which keys
+// are present.
+func (r *DeckRecord) UnmarshalJSON(data []byte) error {
+	var rec struct {
+		Deck        int      `json:"deck"`
+		Track       uint32   `json:"track"`
+		IsAudible   bool     `json:"isAudible"`
+		IsPlaying   bool     `json:"isPlaying"`
+		Volume      *float64 `json:"volume"`
+		ElapsedMs   *int     `json:"elapsedMs"`
+		BPM         *float64 `json:"bpm"`
+		Filename    *string  `json:"filename"`
+		Pitch       *float64 `json:"pitch"`
+		TotalTimeMs *int     `json:"totalTimeMs"`
+		Title       *string  `json:"title"`
+		Artist      *string  `json:"artist"`
+	}
+	if err := json.Unmarshal(data, &rec); err != nil {
+		return err
+	}
+
+	*r = DeckRecord{Track: rec.Track}
+	r.Deck = rec.Deck
+	r.IsAudible = rec.IsAudible
+	r.IsPlaying = rec.IsPlaying
+	if rec.ElapsedMs != nil {
+		r.ElapsedMs, r.Fields = *rec.ElapsedMs, r.Fields|FieldElapsed
+	}
+	if rec.TotalTimeMs != nil {
+		r.TotalTimeMs, r.Fields = *rec.TotalTimeMs, r.Fields|FieldTotalTime
+	}
+	if rec.Volume != nil {
+		r.Volume, r.Fields = *rec.Volume, r.Fields|FieldVolume
+	}
+	if rec.BPM != nil {
+		r.BPM, r.Fields = *rec.BPM, r.Fields|FieldBPM
+	}
+	if rec.Pitch != nil {
+		r.Pitch, r.Fields = *rec.Pitch, r.Fields|FieldPitch
+	}
+	if rec.Filename != nil {
+		r.Filename, r.Fields = *rec.Filename, r.Fields|FieldFilename
+	}
+	if rec.Title != nil {
+		r.Title, r.Fields = *rec.Title, r.Fields|FieldTitle
+	}
+	if rec.Artist != nil {
+		r.Artist, r.Fields = *rec.Artist, r.Fields|FieldArtist
+	}
+	return nil
+}
+
+// DeckBatch is one plugin poll tick: every deck that changed in that
+// tick, read back-to-back so their elapsedMs values are comparable.
+// Frames sent over UDP carry every deck as a snapshot plus sequencing
+// fields; every transport carries the capture time.
+type DeckBatch struct {
+	Decks     []DeckRecord `json:"decks"`
+	Seq       uint64       `json:"seq,omitempty"`       // UDP: +1 per datagram within a session
+	Session   uint32       `json:"session,omitempty"`   // UDP: random per plugin sender run
+	CaptureUs int64        `json:"captureUs,omitempty"` // plugin steady-clock capture time (µs)
+}
+
 // VideoFile represents a video available for playback.
 type VideoFile struct {
 	Name       string  `json:"name"`
@@ -57,3 +183,36 @@ type OverlayElement struct {
 	Config             string `json:"config"`             // JSON config (e.g. custom text value)
 	ShowOverTransition bool   `json:"showOverTransition"` // show above transition videos
 }
+
+// MaxSubscriptions is the most verbs the plugin polls on the server's
+// behalf (the size of its subscription table).
+const MaxSubscriptions = 16
+
+// VerbSubscription asks the plugin to poll one VDJ verb that is not a
+// DeckState field. Scope "deck" reads it once per loaded deck ("deck N
+// verb"), "global" once for the whole mixer.
+type VerbSubscription struct {
+	Verb       string `json:"verb"`
+	Scope      string `json:"scope"`
+	IntervalMs int    `json:"intervalMs"`
+}
+
+// SubscriptionList is what the plugin polls besides DeckState. Version
+// changes whenever the list does, so the plugin can tell it is stale.
+type SubscriptionList struct {
+	Version uint32             `json:"version"`
+	Verbs   []VerbSubscription `json:"verbs"`
+}
+
+// VerbValue is the text of one subscribed verb. Deck is 0 for a global
+// verb.
+type VerbValue struct {
+	Verb  string `json:"verb"`
+	Deck  int    `json:"deck"`
+	Value string `json:"value"`
+}
+
+// VerbValues is a batch of changed subscribed values from the plugin.
+type VerbValues struct {
+	Values []VerbValue `json:"values"`
+}
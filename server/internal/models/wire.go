@@ -0,0 +1,164 @@
+package models
+
+import (
+	"encoding/binary"
+	"encoding/json"
+	"errors"
+	"math"
+)
+
+// WireContentType is the Content-Type of the binary deck frame. The
+// server advertises it in the Accept-Post header of /api/ping; plugins
+// that see it send binary, others keep sending JSON.
+const WireContentType = "application/x-vdj-deck"
+
+// Binary frame layout (little-endian), written by the plugin's
+// CVideoSyncPlugin::encodeFrame and DeckState::appendBinary:
+//
+//	frame: u8 version, u8 deckCount, u16 reserved,
+//	       u32 session, u64 seq, i64 captureUs           (24 bytes)
+//
+// Version 2 deck record:
+//
+//	u8 deck, u8 flags (1 = audible, 2 = playing),
+//	u16 fields (Field* bits), u32 track                  (8 bytes)
+//	then, only for the bits set in fields and in this order:
+//	i32 elapsedMs, i32 totalTimeMs, f64 volume, f64 bpm, f64 pitch,
+//	and filename, title, artist as u16 length + UTF-8 bytes
+//
+// Version 1 deck records are always full snapshots without a track:
+//
+//	u8 deck, u8 flags, u16 reserved, i32 elapsedMs, i32 totalTimeMs,
+//	f64 volume, f64 bpm, f64 pitch, then the three strings
+const (
+	wireFrameHeader = 24
+	wireDeckHeader  = 8
+)
+
+// Largest deck frame a plugin sends, mirroring its kMaxFrameBytes: a
+// JSON frame of full records with numbers of any size and text of
+// MaxDeckText bytes that are all \u00XX escapes. Binary frames are
+// always smaller. A frame of n decks is at most
+// MaxFrameOverhead + n*MaxDeckRecordBytes.
+const (
+	MaxDeckText        = 511 // bytes per filename, title or artist
+	MaxFrameOverhead   = 128
+	MaxDeckRecordBytes = 1280 + 3*(2+6*MaxDeckText)
+)
+
+// ErrWireFormat reports a truncated or unknown-version binary frame.
+var ErrWireFormat = errors.New("invalid binary deck frame")
+
+// wireReader walks a binary frame, remembering whether it ran short.
+type wireReader struct {
+	p  []byte
+	ok bool
+}
+
+func (r *wireReader) take(n int) []byte {
+	if !r.ok || len(r.p) < n {
+		r.ok = false
+		return nil
+	}
+	b := r.p[:n]
+	r.p = r.p[n:]
+	return b
+}
+
+func (r *wireReader) i32() int {
+	if b := r.take(4); b != nil {
+		return int(int32(binary.LittleEndian.Uint32(b)))
+	}
+	return 0
+}
+
+func (r *wireReader) f64() float64 {
+	if b := r.take(8); b != nil {
+		return math.Float64frombits(binary.LittleEndian.Uint64(b))
+	}
+	return 0
+}
+
+func (r *wireReader) str() string {
+	b := r.take(2)
+	if b == nil {
+		return ""
+	}
+	return string(r.take(int(binary.LittleEndian.Uint16(b))))
+}
+
+// DecodeDeckBatch decodes a binary frame. The only allocations are the
+// Decks slice and the strings a record carries.
+func DecodeDeckBatch(data []byte) (DeckBatch, error) {
+	if len(data) < wireFrameHeader || (data[0] != 1 && data[0] != 2) {
+		return DeckBatch{}, ErrWireFormat
+	}
+	le := binary.LittleEndian
+	version := data[0]
+	batch := DeckBatch{
+		Session:   le.Uint32(data[4:]),
+		Seq:       le.Uint64(data[8:]),
+		CaptureUs: int64(le.Uint64(data[16:])),
+		Decks:     make([]DeckRecord, data[1]),
+	}
+
+	r := wireReader{p: data[wireFrameHeader:], ok: true}
+	for i := range batch.Decks {
+		h := r.take(wireDeckHeader)
+		if h == nil {
+			return DeckBatch{}, ErrWireFormat
+		}
+		d := &batch.Decks[i]
+		d.Deck = int(h[0])
+		d.IsAudible = h[1]&1 != 0
+		d.IsPlaying = h[1]&2 != 0
+		if version == 1 {
+			// No track: the header's second half is elapsedMs.
+			d.Fields = FieldsAll
+			d.ElapsedMs = int(int32(le.Uint32(h[4:])))
+		} else {
+			d.Fields = le.Uint16(h[2:])
+			d.Track = le.Uint32(h[4:])
+			if d.Fields&FieldElapsed != 0 {
+				d.ElapsedMs = r.i32()
+			}
+		}
+		if d.Fields&FieldTotalTime != 0 {
+			d.TotalTimeMs = r.i32()
+		}
+		if d.Fields&FieldVolume != 0 {
+			d.Volume = r.f64()
+		}
+		if d.Fields&FieldBPM != 0 {
+			d.BPM = r.f64()
+		}
+		if d.Fields&FieldPitch != 0 {
+			d.Pitch = r.f64()
+		}
+		if d.Fields&FieldFilename != 0 {
+			d.Filename = r.str()
+		}
+		if d.Fields&FieldTitle != 0 {
+			d.Title = r.str()
+		}
+		if d.Fields&FieldArtist != 0 {
+			d.Artist = r.str()
+		}
+		if !r.ok {
+			return DeckBatch{}, ErrWireFormat
+		}
+	}
+	return batch, nil
+}
+
+// DecodeDeckFrame decodes a frame whose format is not labelled (a UDP
+// datagram): JSON frames always start with '{', binary ones with the
+// version byte.
+func DecodeDeckFrame(data []byte) (DeckBatch, error) {
+	if len(data) > 0 && data[0] == '{' {
+		var batch DeckBatch
+		err := json.Unmarshal(data, &batch)
+		return batch, err
+	}
+	return DecodeDeckBatch(data)
+}
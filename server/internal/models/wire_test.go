@@ -0,0 +1,223 @@
+package models
+
+import (
+	"encoding/binary"
+	"encoding/json"
+	"errors"
+	"math"
+	"reflect"
+	"testing"
+)
+
+// appendWire encodes batch the way the plugin's encodeFrame and
+// DeckState::appendBinary do. Version 1 writes every record in full
+// and without a track.
+func appendWire(b []byte, batch DeckBatch, version byte) []byte {
+	le := binary.LittleEndian
+	b = append(b, version, byte(len(batch.Decks)), 0, 0)
+	b = le.AppendUint32(b, batch.Session)
+	b = le.AppendUint64(b, batch.Seq)
+	b = le.AppendUint64(b, uint64(batch.CaptureUs))
+	for _, d := range batch.Decks {
+		var flags byte
+		if d.IsAudible {
+			flags |= 1
+		}
+		if d.IsPlaying {
+			flags |= 2
+		}
+		fields := d.Fields
+		b = append(b, byte(d.Deck), flags)
+		if version == 1 {
+			fields = FieldsAll
+			b = append(b, 0, 0)
+			b = le.AppendUint32(b, uint32(int32(d.ElapsedMs)))
+		} else {
+			b = le.AppendUint16(b, fields)
+			b = le.AppendUint32(b, d.Track)
+			if fields&FieldElapsed != 0 {
+				b = le.AppendUint32(b, uint32(int32(d.ElapsedMs)))
+			}
+		}
+		if fields&FieldTotalTime != 0 {
+			b = le.AppendUint32(b, uint32(int32(d.TotalTimeMs)))
+		}
+		for _, f := range []struct {
+			bit uint16
+			v   float64
+		}{{FieldVolume, d.Volume}, {FieldBPM, d.BPM}, {FieldPitch, d.Pitch}} {
+			if fields&f.bit != 0 {
+				b = le.AppendUint64(b, math.Float64bits(f.v))
+			}
+		}
+		for _, f := range []struct {
+			bit uint16
+			s   string
+		}{{FieldFilename, d.Filename}, {FieldTitle, d.Title}, {FieldArtist, d.Artist}} {
+			if fields&f.bit != 0 {
+				b = le.AppendUint16(b, uint16(len(f.s)))
+				b = append(b, f.s...)
+			}
+		}
+	}
+	return b
+}
+
+// A tick as the plugin posts it as JSON: a snapshot of a newly loaded
+// track and a delta of a playing deck (elapsed time and volume only).
+const tickJSON = `{"captureUs":81234567,"decks":[` +
+	`{"deck":1,"track":7,"isAudible":true,"isPlaying":true,"volume":0.800000,"elapsedMs":61250,` +
+	`"bpm":124.000000,"filename":"Artist - Track (Extended Mix).mp4","pitch":100.500000,` +
+	`"totalTimeMs":372000,"title":"Track é","artist":"Artist"},` +
+	`{"deck":2,"track":3,"isAudible":false,"isPlaying":true,"volume":0.250000,"elapsedMs":1500}]}`
+
+// The same decks as a plugin without deltas sends them: every record a
+// snapshot, no track.
+const snapshotJSON = `{"captureUs":5000,"decks":[` +
+	`{"deck":1,"isAudible":true,"isPlaying":false,"volume":1.000000,"elapsedMs":0,"bpm":128.000000,` +
+	`"filename":"a.mp4","pitch":100.000000,"totalTimeMs":200000,"title":"","artist":""},` +
+	`{"deck":4,"isAudible":false,"isPlaying":true,"volume":0.000000,"elapsedMs":-20,"bpm":0.000000,` +
+	`"filename":"b.mp4","pitch":92.000000,"totalTimeMs":1000,"title":"B","artist":"b"}]}`
+
+func decodeJSON(t testing.TB, data string) DeckBatch {
+	t.Helper()
+	var batch DeckBatch
+	if err := json.Unmarshal([]byte(data), &batch); err != nil {
+		t.Fatalf("json: %v", err)
+	}
+	return batch
+}
+
+func TestDecodeDeckBatchMatchesJSON(t *testing.T) {
+	for _, tc := range []struct {
+		name    string
+		json    string
+		version byte
+	}{
+		{"v2 snapshot and delta", tickJSON, 2},
+		{"v2 snapshots", snapshotJSON, 2},
+		{"v1 snapshots", snapshotJSON, 1},
+	} {
+		t.Run(tc.name, func(t *testing.T) {
+			want := decodeJSON(t, tc.json)
+			got, err := DecodeDeckBatch(appendWire(nil, want, tc.version))
+			if err != nil {
+				t.Fatalf("decode: %v", err)
+			}
+			if !reflect.DeepEqual(got, want) {
+				t.Errorf("binary decoded to\n%+v\nJSON to\n%+v", got, want)
+			}
+		})
+	}
+}
+
+func TestDecodeDeckBatchDelta(t *testing.T) {
+	batch := decodeJSON(t, tickJSON)
+	if !batch.Decks[0].IsSnapshot() || batch.Decks[1].IsSnapshot() {
+		t.Fatalf("fields %#x, %#x: want a snapshot then a delta", batch.Decks[0].Fields, batch.Decks[1].Fields)
+	}
+	got, err := DecodeDeckBatch(appendWire(nil, batch, 2))
+	if err != nil {
+		t.Fatalf("decode: %v", err)
+	}
+	if want := FieldElapsed | FieldVolume; got.Decks[1].Fields != want {
+		t.Errorf("delta fields = %#x, want %#x", got.Decks[1].Fields, want)
+	}
+
+	// The delta only touches the fields it carries.
+	state := got.Decks[0].DeckState
+	state.Deck = 2
+	got.Decks[1].MergeInto(&state)
+	if state.ElapsedMs != 1500 || state.Volume != 0.25 || state.IsAudible || state.Filename != got.Decks[0].Filename {
+		t.Errorf("merged state %+v", state)
+	}
+}
+
+func TestDecodeDeckBatchSequencing(t *testing.T) {
+	batch := decodeJSON(t, snapshotJSON)
+	batch.Seq, batch.Session = 1<<40+3, 0xDEADBEEF
+	frame := appendWire(nil, batch, 2)
+	for _, decode := range []func([]byte) (DeckBatch, error){DecodeDeckBatch, DecodeDeckFrame} {
+		got, err := decode(frame)
+		if err != nil {
+			t.Fatalf("decode: %v", err)
+		}
+		if got.Seq != batch.Seq || got.Session != batch.Session || got.CaptureUs != batch.CaptureUs {
+			t.Errorf("seq %d session %#x capture %d", got.Seq, got.Session, got.CaptureUs)
+		}
+	}
+}
+
+func TestDecodeDeckFrameJSON(t *testing.T) {
+	got, err := DecodeDeckFrame([]byte(tickJSON))
+	if err != nil {
+		t.Fatalf("decode: %v", err)
+	}
+	if want := decodeJSON(t, tickJSON); !reflect.DeepEqual(got, want) {
+		t.Errorf("got %+v, want %+v", got, want)
+	}
+}
+
+func TestDecodeDeckBatchTruncated(t *testing.T) {
+	for _, version := range []byte{1, 2} {
+		frame := appendWire(nil, decodeJSON(t, snapshotJSON), version)
+		for n := 0; n < len(frame); n++ {
+			if _, err := DecodeDeckBatch(frame[:n]); !errors.Is(err, ErrWireFormat) {
+				t.Fatalf("v%d cut to %d of %d bytes: err = %v, want ErrWireFormat", version, n, len(frame), err)
+			}
+		}
+	}
+}
+
+func TestDecodeDeckBatchVersion(t *testing.T) {
+	frame := appendWire(nil, decodeJSON(t, tickJSON), 2)
+	for _, version := range []byte{0, 3, '{', 0xFF} {
+		frame[0] = version
+		if _, err := DecodeDeckBatch(frame); !errors.Is(err, ErrWireFormat) {
+			t.Errorf("version %d: err = %v, want ErrWireFormat", version, err)
+		}
+	}
+}
+
+func TestDecodeDeckBatchLongText(t *testing.T) {
+	batch := decodeJSON(t, snapshotJSON)
+	long := make([]byte, MaxDeckText)
+	for i := range long {
+		long[i] = 'a' + byte(i%26)
+	}
+	batch.Decks[0].Title = string(long)
+	got, err := DecodeDeckBatch(appendWire(nil, batch, 2))
+	if err != nil {
+		t.Fatalf("decode: %v", err)
+	}
+	if got.Decks[0].Title != batch.Decks[0].Title {
+		t.Errorf("title of %d bytes came back as %d", len(batch.Decks[0].Title), len(got.Decks[0].Title))
+	}
+}
+
+// The two benchmarks decode the same tick; bytes/update is the frame
+// size per deck record, the wire cost of one deck update.
+func BenchmarkDecodeDeckBatchJSON(b *testing.B) {
+	frame := []byte(tickJSON)
+	b.ReportAllocs()
+	b.SetBytes(int64(len(frame)))
+	for i := 0; i < b.N; i++ {
+		var batch DeckBatch
+		if err := json.Unmarshal(frame, &batch); err != nil {
+			b.Fatal(err)
+		}
+	}
+	b.ReportMetric(float64(len(frame))/2, "bytes/update")
+}
+
+func BenchmarkDecodeDeckBatchBinary(b *testing.B) {
+	frame := appendWire(nil, decodeJSON(b, tickJSON), 2)
+	b.ReportAllocs()
+	b.SetBytes(int64(len(frame)))
+	for i := 0; i < b.N; i++ {
+		if _, err := DecodeDeckBatch(frame); err != nil {
+			b.Fatal(err)
+		}
+	}
+	b.ReportMetric(float64(len(frame))/2, "bytes/update")
+}
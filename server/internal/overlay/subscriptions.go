@@ -0,0 +1,112 @@
+package overlay
+
+import (
+	"encoding/json"
+	"hash/fnv"
+	"sort"
+
+	"github.com/jota2rz/vdj-video-sync/server/internal/models"
+)
+
+// Subscription defaults and bounds. The plugin polls every 50 ms, so a
+// shorter interval would not be honoured anyway.
+const (
+	defaultIntervalMs = 500
+	minIntervalMs     = 50
+	maxIntervalMs     = 60000
+	maxVerbLen        = 63 // plugin buffer, without the terminator
+)
+
+// deckStateVerbs are the verbs the plugin always reads as DeckState
+// fields; overlays bound to them need no subscription.
+var deckStateVerbs = map[string]bool{
+	"get_songlength":            true,
+	"is_audible":                true,
+	"play":                      true,
+	"get_volume":                true,
+	"get_time elapsed absolute": true,
+	"get_pitch_value":           true,
+	"get_bpm":                   true,
+	"get_filename":              true,
+	"get_title":                 true,
+	"get_artist":                true,
+}
+
+// subscriptionConfig is the part of an element's config that shapes its
+// subscription: {"scope":"global","intervalMs":1000}. Both are optional.
+type subscriptionConfig struct {
+	Scope      string `json:"scope"`
+	IntervalMs int    `json:"intervalMs"`
+}
+
+// validVerb reports whether the plugin can poll v as-is: printable ASCII
+// without the quotes and backticks VDJ scripts treat specially.
+func validVerb(v string) bool {
+	if v == "" || len(v) > maxVerbLen {
+		return false
+	}
+	for i := 0; i < len(v); i++ {
+		c := v[i]
+		if c < 0x20 || c > 0x7e || c == '"' || c == '\\' || c == '`' || c == '\'' {
+			return false
+		}
+	}
+	return true
+}
+
+// Subscriptions derives the verbs the plugin must poll from the enabled
+// verb-bound elements. Elements sharing a verb and scope share one
+// subscription at the shortest interval. The list is sorted so that the
+// version, a hash of it, only changes when the list does.
+func (s *Store) Subscriptions() (models.SubscriptionList, error) {
+	elements, err := s.ListEnabled()
+	if err != nil {
+		return models.SubscriptionList{}, err
+	}
+
+	byKey := make(map[models.VerbSubscription]int) // interval-less key → index
+	verbs := []models.VerbSubscription{}
+	for _, e := range elements {
+		if e.DataType != "verb" || deckStateVerbs[e.Verb] || !validVerb(e.Verb) {
+			continue
+		}
+		var cfg subscriptionConfig
+		json.Unmarshal([]byte(e.Config), &cfg)
+		sub := models.VerbSubscription{Verb: e.Verb, Scope: "deck"}
+		if cfg.Scope == "global" {
+			sub.Scope = "global"
+		}
+		interval := cfg.IntervalMs
+		if interval <= 0 {
+			interval = defaultIntervalMs
+		}
+		interval = min(max(interval, minIntervalMs), maxIntervalMs)
+
+		if i, ok := byKey[sub]; ok {
+			verbs[i].IntervalMs = min(verbs[i].IntervalMs, interval)
+			continue
+		}
+		byKey[sub] = len(verbs)
+		sub.IntervalMs = interval
+		verbs = append(verbs, sub)
+	}
+
+	sort.Slice(verbs, func(i, j int) bool {
+		if verbs[i].Verb != verbs[j].Verb {
+			return verbs[i].Verb < verbs[j].Verb
+		}
+		return verbs[i].Scope < verbs[j].Scope
+	})
+	if len(verbs) > models.MaxSubscriptions {
+		verbs = verbs[:models.MaxSubscriptions]
+	}
+
+	data, _ := json.Marshal(verbs)
+	h := fnv.New32a()
+	h.Write(data)
+	version := h.Sum32()
+	if version == 0 {
+		version = 1 // 0 means "no list yet" to the plugin
+	}
+	return models.SubscriptionList{Version: version, Verbs: verbs}, nil
+}
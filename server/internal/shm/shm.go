@@ -0,0 +1,309 @@
+// Package shm reads deck frames the plugin writes into a memory-mapped
+// ring file when it runs on the same machine as the server.
+//
+// The ring is a fixed array of slots, each guarded by its own seqlock
+// (layout in plugin/src/ShmRing.h). The plugin never waits for the
+// reader: if the reader falls behind by a whole ring, the overwritten
+// frames are counted as lost. Every frame is a complete DeckBatch, so
+// the next one repairs the gap. The reader stamps a pulse into the
+// header while it runs; without it the plugin falls back to HTTP.
+package shm
+
+import (
+	"encoding/binary"
+	"log/slog"
+	"os"
+	"path/filepath"
+	"runtime/debug"
+	"sync"
+	"sync/atomic"
+	"time"
+	"unsafe"
+
+	"github.com/jota2rz/vdj-video-sync/server/internal/models"
+)
+
+// Ring file layout (see plugin/src/ShmRing.h).
+const (
+	ringMagic      = 0x524A4456 // "VDJR"
+	ringVersion    = 1
+	headerSize     = 64
+	slotHeaderSize = 16
+
+	offMagic       = 0
+	offVersion     = 4
+	offSlotCount   = 8
+	offSlotSize    = 12
+	offWriteIndex  = 16
+	offReaderPulse = 24
+)
+
+const (
+	activePoll  = time.Millisecond      // poll interval while frames arrive
+	idlePoll    = 10 * time.Millisecond // poll interval once the plugin goes quiet
+	idleAfter   = time.Second           // quiet time before switching to idlePoll
+	retryMap    = time.Second           // while the ring file is missing or invalid
+	tornRetries = 3                     // re-reads of a slot the writer is filling
+)
+
+// DefaultPath is where the plugin creates its ring:
+// vdj-video-sync.ring in the user's temp directory.
+func DefaultPath() string {
+	return filepath.Join(os.TempDir(), "vdj-video-sync.ring")
+}
+
+// Stats are the reader's cumulative counters.
+type Stats struct {
+	Mapped   bool   `json:"mapped"`   // the ring file is currently mapped
+	Records  uint64 `json:"records"`  // records read from the ring
+	Applied  uint64 `json:"applied"`  // frames handed to apply
+	Lost     uint64 `json:"lost"`     // records overwritten before they were read
+	Torn     uint64 `json:"torn"`     // slot reads retried because the writer was mid-copy
+	Invalid  uint64 `json:"invalid"`  // not a decodable frame
+	Sessions uint64 `json:"sessions"` // plugin sender restarts seen
+	LastSeq  uint64 `json:"lastSeq"`
+}
+
+// Reader maps the ring file and applies the frames written to it.
+type Reader struct {
+	path      string
+	apply     func(models.DeckBatch)
+	done      chan struct{}
+	closeOnce sync.Once
+
+	mu    sync.Mutex
+	stats Stats
+
+	// Owned by Serve.
+	data      []byte
+	slotCount uint64
+	slotSize  uint64
+	next      uint64 // index of the next record to read
+	session   uint32
+	started   bool
+	buf       []byte
+}
+
+// New returns a reader for the ring file at path. The file need not
+// exist yet: Serve maps it once the plugin has created it.
+func New(path string, apply func(models.DeckBatch)) *Reader {
+	return &Reader{path: path, apply: apply, done: make(chan struct{})}
+}
+
+// Serve polls the ring until Close is called. apply is called from the
+// reader's goroutine, in write order.
+func (r *Reader) Serve() {
+	// A ring truncated under us by another writer faults on access;
+	// turn that into a remap instead of a crash.
+	debug.SetPanicOnFault(true)
+	defer r.unmap()
+
+	timer := time.NewTimer(0)
+	defer timer.Stop()
+	lastFrame := time.Now()
+	for {
+		select {
+		case <-r.done:
+			return
+		case <-timer.C:
+		}
+
+		wait := retryMap
+		if r.data != nil || r.mapRing() {
+			if r.poll() > 0 {
+				lastFrame = time.Now()
+			}
+			switch {
+			case r.data == nil:
+				wait = retryMap
+			case time.Since(lastFrame) < idleAfter:
+				wait = activePoll
+			default:
+				wait = idlePoll
+			}
+		}
+		timer.Reset(wait)
+	}
+}
+
+// Stats returns a snapshot of the counters.
+func (r *Reader) Stats() Stats {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	return r.stats
+}
+
+// Close stops Serve and unmaps the ring.
+func (r *Reader) Close() error {
+	r.closeOnce.Do(func() { close(r.done) })
+	return nil
+}
+
+// mapRing maps the ring file if it exists and carries a valid header.
+// Reading starts at the current write position; older records are stale.
+func (r *Reader) mapRing() bool {
+	f, err := os.OpenFile(r.path, os.O_RDWR, 0)
+	if err != nil {
+		return false
+	}
+	defer f.Close()
+	info, err := f.Stat()
+	if err != nil || info.Size() < headerSize {
+		return false
+	}
+	data, err := mapFile(f, int(info.Size()))
+	if err != nil {
+		slog.Warn("shm ring map failed", "path", r.path, "error", err)
+		return false
+	}
+	r.data = data
+	if !r.validHeader() {
+		r.unmap()
+		return false
+	}
+	r.slotCount = uint64(r.load32(offSlotCount))
+	r.slotSize = uint64(r.load32(offSlotSize))
+	r.next = r.load64(offWriteIndex)
+	r.buf = make([]byte, r.slotSize-slotHeaderSize)
+
+	r.mu.Lock()
+	r.stats.Mapped = true
+	r.mu.Unlock()
+	slog.Info("shm ring mapped", "path", r.path, "slots", r.slotCount)
+	return true
+}
+
+func (r *Reader) unmap() {
+	if r.data == nil {
+		return
+	}
+	if err := unmapFile(r.data); err != nil {
+		slog.Warn("shm ring unmap failed", "error", err)
+	}
+	r.data = nil
+	r.buf = nil
+	r.mu.Lock()
+	r.stats.Mapped = false
+	r.mu.Unlock()
+}
+
+// validHeader checks the magic, version and that the slot geometry fits
+// the mapping (and has not changed since it was mapped).
+func (r *Reader) validHeader() bool {
+	if r.load32(offMagic) != ringMagic || r.load32(offVersion) != ringVersion {
+		return false
+	}
+	count, size := uint64(r.load32(offSlotCount)), uint64(r.load32(offSlotSize))
+	if count == 0 || size <= slotHeaderSize || size%8 != 0 ||
+		headerSize+count*size > uint64(len(r.data)) {
+		return false
+	}
+	return r.buf == nil || (count == r.slotCount && size == r.slotSize)
+}
+
+// poll reads every record published since the last call and returns how
+// many frames were applied. It unmaps the ring if it became invalid.
+func (r *Reader) poll() (applied int) {
+	defer func() {
+		if err := recover(); err != nil {
+			slog.Warn("shm ring fault, remapping", "error", err)
+			r.unmap()
+		}
+	}()
+
+	if !r.validHeader() {
+		r.unmap()
+		return 0
+	}
+	atomic.StoreUint64(r.word(offReaderPulse), uint64(time.Now().UnixMilli()))
+
+	w := r.load64(offWriteIndex)
+	if w < r.next {
+		r.next = w // the plugin re-created the ring
+	}
+	var lost, torn, invalid uint64
+	if w-r.next > r.slotCount {
+		lost += w - r.next - r.slotCount
+		r.next = w - r.slotCount
+	}
+	for ; r.next < w; r.next++ {
+		payload, retries, ok := r.readSlot(r.next)
+		torn += retries
+		if !ok {
+			lost++
+			continue
+		}
+		batch, err := models.DecodeDeckFrame(payload)
+		if err != nil || batch.Seq == 0 {
+			invalid++
+			continue
+		}
+		r.track(batch)
+		r.apply(batch)
+		applied++
+	}
+
+	r.mu.Lock()
+	r.stats.Records += uint64(applied) + invalid
+	r.stats.Applied += uint64(applied)
+	r.stats.Lost += lost
+	r.stats.Torn += torn
+	r.stats.Invalid += invalid
+	r.mu.Unlock()
+	return applied
+}
+
+// readSlot copies record n out of its slot. ok is false if the writer
+// has already lapped it or kept rewriting it through every retry.
+func (r *Reader) readSlot(n uint64) (payload []byte, retries uint64, ok bool) {
+	off := headerSize + (n%r.slotCount)*r.slotSize
+	want := 2*n + 2
+	for ; retries <= tornRetries; retries++ {
+		seq := r.load64(off)
+		if seq > want {
+			return nil, retries, false // overwritten by a later lap
+		}
+		if seq == want {
+			length := uint64(r.load32(off + 8))
+			if length > r.slotSize-slotHeaderSize {
+				return nil, retries, false
+			}
+			// Word-sized atomic loads keep the copy ordered before the
+			// seq re-check on weakly ordered CPUs.
+			for i := uint64(0); i < length; i += 8 {
+				binary.LittleEndian.PutUint64(r.buf[i:], r.load64(off+slotHeaderSize+i))
+			}
+			if r.load64(off) == want {
+				return r.buf[:length], retries, true
+			}
+		}
+	}
+	return nil, retries, false
+}
+
+// track follows the plugin's sender session for the stats.
+func (r *Reader) track(batch models.DeckBatch) {
+	r.mu.Lock()
+	defer r.mu.Unlock()
+	if !r.started || batch.Session != r.session {
+		if r.started {
+			slog.Info("shm plugin session restarted", "session", batch.Session)
+		}
+		r.session = batch.Session
+		r.started = true
+		r.stats.Sessions++
+	}
+	r.stats.LastSeq = batch.Seq
+}
+
+func (r *Reader) word(off uint64) *uint64 {
+	return (*uint64)(unsafe.Pointer(&r.data[off]))
+}
+
+func (r *Reader) load64(off uint64) uint64 {
+	return atomic.LoadUint64(r.word(off))
+}
+
+func (r *Reader) load32(off uint64) uint32 {
+	return atomic.LoadUint32((*uint32)(unsafe.Pointer(&r.data[off])))
+}
@@ -0,0 +1,258 @@
+//go:build unix
+
+package shm
+
+import (
+	"encoding/binary"
+	"os"
+	"path/filepath"
+	"sort"
+	"sync"
+	"sync/atomic"
+	"testing"
+	"time"
+	"unsafe"
+
+	"github.com/jota2rz/vdj-video-sync/server/internal/models"
+)
+
+// A small ring so the writer laps the reader and overwrites slots it
+// is copying.
+const (
+	testSlotCount = 8
+	testSlotSize  = 256
+	testText      = 96 // filename bytes per frame
+	testSession   = 0x5EED
+)
+
+// ringWriter publishes frames the way the plugin's ShmRing::write does:
+// mark the slot odd, copy, mark it even, then advance writeIndex.
+type ringWriter struct {
+	data []byte
+	next uint64
+}
+
+func newRingWriter(t *testing.T, path string) *ringWriter {
+	t.Helper()
+	f, err := os.OpenFile(path, os.O_RDWR|os.O_CREATE|os.O_TRUNC, 0o600)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer f.Close()
+	size := headerSize + testSlotCount*testSlotSize
+	if err := f.Truncate(int64(size)); err != nil {
+		t.Fatal(err)
+	}
+	data, err := mapFile(f, size)
+	if err != nil {
+		t.Fatal(err)
+	}
+	t.Cleanup(func() { unmapFile(data) })
+
+	w := &ringWriter{data: data}
+	w.store32(offMagic, ringMagic)
+	w.store32(offVersion, ringVersion)
+	w.store32(offSlotCount, testSlotCount)
+	w.store32(offSlotSize, testSlotSize)
+	return w
+}
+
+// write publishes frame as record w.next. The payload goes in with
+// word-sized atomic stores: the plugin's memcpy is the same race with
+// the reader, but the race detector would flag it in Go.
+func (w *ringWriter) write(frame []byte) {
+	off := uint64(headerSize + (w.next%testSlotCount)*testSlotSize)
+	atomic.StoreUint64(w.word(off), 2*w.next+1)
+	atomic.StoreUint32((*uint32)(unsafe.Pointer(&w.data[off+8])), uint32(len(frame)))
+	var word [8]byte
+	for i := 0; i < len(frame); i += 8 {
+		n := copy(word[:], frame[i:])
+		clear(word[n:])
+		atomic.StoreUint64(w.word(off+slotHeaderSize+uint64(i)), binary.LittleEndian.Uint64(word[:]))
+	}
+	atomic.StoreUint64(w.word(off), 2*w.next+2)
+	w.next++
+	atomic.StoreUint64(w.word(offWriteIndex), w.next)
+}
+
+func (w *ringWriter) word(off uint64) *uint64 {
+	return (*uint64)(unsafe.Pointer(&w.data[off]))
+}
+
+func (w *ringWriter) store32(off uint64, v uint32) {
+	atomic.StoreUint32((*uint32)(unsafe.Pointer(&w.data[off])), v)
+}
+
+// testFrame is a one-deck binary frame whose every field is derived
+// from seq, so a frame copied from two different records shows up as a
+// mismatch.
+func testFrame(seq uint64) []byte {
+	le := binary.LittleEndian
+	b := make([]byte, 0, testSlotSize-slotHeaderSize)
+	b = append(b, 2, 1, 0, 0)
+	b = le.AppendUint32(b, testSession)
+	b = le.AppendUint64(b, seq)
+	b = le.AppendUint64(b, seq*1000)
+	b = append(b, 1, 0)
+	b = le.AppendUint16(b, models.FieldElapsed|models.FieldFilename)
+	b = le.AppendUint32(b, uint32(seq))
+	b = le.AppendUint32(b, uint32(seq))
+	b = le.AppendUint16(b, testText)
+	for i := 0; i < testText; i++ {
+		b = append(b, 'a'+byte(seq%26))
+	}
+	return b
+}
+
+// checkFrame reports whether batch is intact: every field agrees with
+// its seq.
+func checkFrame(batch models.DeckBatch) bool {
+	if batch.Session != testSession || batch.CaptureUs != int64(batch.Seq*1000) || len(batch.Decks) != 1 {
+		return false
+	}
+	d := batch.Decks[0]
+	if d.Track != uint32(batch.Seq) || d.ElapsedMs != int(batch.Seq) || len(d.Filename) != testText {
+		return false
+	}
+	for i := 0; i < testText; i++ {
+		if d.Filename[i] != 'a'+byte(batch.Seq%26) {
+			return false
+		}
+	}
+	return true
+}
+
+// serve runs r until the test ends and waits for Serve to return.
+func serve(t *testing.T, r *Reader) {
+	done := make(chan struct{})
+	go func() {
+		r.Serve()
+		close(done)
+	}()
+	t.Cleanup(func() {
+		r.Close()
+		<-done
+	})
+}
+
+// waitFor polls cond until it holds or the deadline passes.
+func waitFor(t *testing.T, what string, cond func() bool) {
+	t.Helper()
+	deadline := time.Now().Add(5 * time.Second)
+	for !cond() {
+		if time.Now().After(deadline) {
+			t.Fatalf("timed out waiting for %s", what)
+		}
+		time.Sleep(time.Millisecond)
+	}
+}
+
+func TestReaderStress(t *testing.T) {
+	path := filepath.Join(t.TempDir(), "test.ring")
+	w := newRingWriter(t, path)
+
+	var (
+		mu      sync.Mutex
+		lastSeq uint64
+		bad     []string
+	)
+	r := New(path, func(batch models.DeckBatch) {
+		mu.Lock()
+		defer mu.Unlock()
+		switch {
+		case batch.Seq <= lastSeq:
+			bad = append(bad, "out of order")
+		case !checkFrame(batch):
+			bad = append(bad, "torn")
+		}
+		lastSeq = batch.Seq
+	})
+	serve(t, r)
+	waitFor(t, "the ring to be mapped", func() bool { return r.Stats().Mapped })
+
+	// Seqs start at 1, as the plugin's do; record n carries seq n+1.
+	// Short pauses let the reader catch up between bursts, so it reads
+	// the slots the writer is filling rather than only lapped ones.
+	const frames = 10000
+	for w.next < frames {
+		w.write(testFrame(w.next + 1))
+		if w.next%testSlotCount == 0 {
+			time.Sleep(50 * time.Microsecond)
+		}
+	}
+	waitFor(t, "the reader to catch up", func() bool {
+		s := r.Stats()
+		return s.Records+s.Lost == frames
+	})
+
+	s := r.Stats()
+	t.Logf("applied %d, lost %d, torn retries %d", s.Applied, s.Lost, s.Torn)
+	mu.Lock()
+	defer mu.Unlock()
+	if len(bad) > 0 {
+		t.Fatalf("%d bad frames, first: %s", len(bad), bad[0])
+	}
+	if s.Invalid != 0 || s.Applied == 0 || s.LastSeq != frames || lastSeq != frames {
+		t.Errorf("stats %+v, last applied seq %d", s, lastSeq)
+	}
+	if s.Sessions != 1 {
+		t.Errorf("sessions = %d, want 1", s.Sessions)
+	}
+	if binary.LittleEndian.Uint64(w.data[offReaderPulse:]) == 0 {
+		t.Error("reader never stamped its pulse")
+	}
+}
+
+// TestReaderHandoffLatency measures the time from a write to its apply,
+// first while frames keep arriving (activePoll) and then after the
+// plugin has been quiet for idleAfter (idlePoll).
+func TestReaderHandoffLatency(t *testing.T) {
+	if testing.Short() {
+		t.Skip("waits out the idle switch")
+	}
+	path := filepath.Join(t.TempDir(), "test.ring")
+	w := newRingWriter(t, path)
+	applied := make(chan time.Time, 1)
+	r := New(path, func(models.DeckBatch) { applied <- time.Now() })
+	serve(t, r)
+	waitFor(t, "the ring to be mapped", func() bool { return r.Stats().Mapped })
+
+	handoff := func() time.Duration {
+		w.write(testFrame(w.next + 1))
+		start := time.Now()
+		select {
+		case at := <-applied:
+			return at.Sub(start)
+		case <-time.After(5 * time.Second):
+			t.Fatal("frame never applied")
+			return 0
+		}
+	}
+	median := func(d []time.Duration) time.Duration {
+		sort.Slice(d, func(i, j int) bool { return d[i] < d[j] })
+		return d[len(d)/2]
+	}
+
+	var active []time.Duration
+	for i := 0; i < 50; i++ {
+		active = append(active, handoff())
+	}
+	time.Sleep(idleAfter + 50*time.Millisecond)
+	var idle []time.Duration
+	for i := 0; i < 3; i++ {
+		// Only the first frame after the pause sees the idle poll; the
+		// reader is back to activePoll as soon as it lands.
+		idle = append(idle, handoff())
+		time.Sleep(idleAfter + 20*time.Millisecond)
+	}
+
+	a, i := median(active), median(idle)
+	t.Logf("handoff median: active %v (poll %v), idle %v (poll %v)", a, activePoll, i, idlePoll)
+	// Loose bounds: the timer slack of a loaded CI runner under -race.
+	if a > 5*activePoll {
+		t.Errorf("active handoff median %v, want about %v", a, activePoll)
+	}
+	if i > 3*idlePoll {
+		t.Errorf("idle handoff median %v, want about %v", i, idlePoll)
+	}
+}
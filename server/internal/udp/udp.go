@@ -0,0 +1,134 @@
+// Package udp receives deck frames the plugin sends as UDP datagrams.
+//
+// Each datagram is a complete DeckBatch (JSON or the binary wire format)
+// carrying a session id and a sequence number. Anything not newer than
+// the last applied datagram is stale (the newer one already superseded
+// it) and is dropped, so the listener never moves a deck backwards.
+// Gaps and late arrivals are counted for the stats endpoint.
+package udp
+
+import (
+	"errors"
+	"log/slog"
+	"net"
+	"sync"
+
+	"github.com/jota2rz/vdj-video-sync/server/internal/models"
+)
+
+// maxDatagram is the largest UDP payload, so no frame is ever truncated.
+const maxDatagram = 65535
+
+// Stats are the listener's cumulative counters.
+type Stats struct {
+	Received   uint64 `json:"received"`   // datagrams read from the socket
+	Applied    uint64 `json:"applied"`    // in-order frames handed to apply
+	Lost       uint64 `json:"lost"`       // sequence numbers never seen
+	Reordered  uint64 `json:"reordered"`  // arrived after a newer frame; dropped
+	Duplicates uint64 `json:"duplicates"` // same sequence number twice; dropped
+	Invalid    uint64 `json:"invalid"`    // not a decodable frame
+	Sessions   uint64 `json:"sessions"`   // plugin sender restarts seen
+	LastSeq    uint64 `json:"lastSeq"`
+}
+
+// Listener reads datagrams and applies in-order frames.
+type Listener struct {
+	conn  *net.UDPConn
+	apply func(models.DeckBatch)
+
+	mu      sync.Mutex
+	stats   Stats
+	session uint32
+	started bool // a frame of the current session has been applied
+}
+
+// Listen binds addr (e.g. ":8090"). apply is called from the listener's
+// goroutine for every frame that is newer than all before it.
+func Listen(addr string, apply func(models.DeckBatch)) (*Listener, error) {
+	udpAddr, err := net.ResolveUDPAddr("udp", addr)
+	if err != nil {
+		return nil, err
+	}
+	conn, err := net.ListenUDP("udp", udpAddr)
+	if err != nil {
+		return nil, err
+	}
+	return &Listener{conn: conn, apply: apply}, nil
+}
+
+// Serve reads datagrams until Close is called.
+func (l *Listener) Serve() {
+	buf := make([]byte, maxDatagram)
+	for {
+		n, _, err := l.conn.ReadFromUDP(buf)
+		if err != nil {
+			if errors.Is(err, net.ErrClosed) {
+				return
+			}
+			slog.Warn("udp read failed", "error", err)
+			continue
+		}
+
+		batch, err := models.DecodeDeckFrame(buf[:n])
+		if err != nil || batch.Seq == 0 {
+			l.mu.Lock()
+			l.stats.Received++
+			l.stats.Invalid++
+			l.mu.Unlock()
+			continue
+		}
+		if l.accept(batch.Session, batch.Seq) {
+			l.apply(batch)
+		}
+	}
+}
+
+// accept updates the sequence tracking and reports whether a frame with
+// this session and seq should be applied.
+func (l *Listener) accept(session uint32, seq uint64) bool {
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	l.stats.Received++
+
+	if !l.started || session != l.session {
+		if l.started {
+			slog.Info("udp plugin session restarted", "session", session)
+		}
+		l.session = session
+		l.started = true
+		l.stats.Sessions++
+		l.stats.LastSeq = seq
+		l.stats.Applied++
+		return true
+	}
+
+	switch {
+	case seq > l.stats.LastSeq:
+		l.stats.Lost += seq - l.stats.LastSeq - 1
+		l.stats.LastSeq = seq
+		l.stats.Applied++
+		return true
+	case seq == l.stats.LastSeq:
+		l.stats.Duplicates++
+	default:
+		// A late frame was counted as lost when the gap appeared; it
+		// arrived after all, just too late to use.
+		l.stats.Reordered++
+		if l.stats.Lost > 0 {
+			l.stats.Lost--
+		}
+	}
+	return false
+}
+
+// Stats returns a snapshot of the counters.
+func (l *Listener) Stats() Stats {
+	l.mu.Lock()
+	defer l.mu.Unlock()
+	return l.stats
+}
+
+// Close stops Serve.
+func (l *Listener) Close() error {
+	return l.conn.Close()
+}
@@ -18,14 +18,18 @@ import (
 	"github.com/jota2rz/vdj-video-sync/server/internal/db"
 	"github.com/jota2rz/vdj-video-sync/server/internal/handlers"
 	"github.com/jota2rz/vdj-video-sync/server/internal/overlay"
+	"github.com/jota2rz/vdj-video-sync/server/internal/shm"
 	"github.com/jota2rz/vdj-video-sync/server/internal/sse"
 	"github.com/jota2rz/vdj-video-sync/server/internal/transitions"
+	"github.com/jota2rz/vdj-video-sync/server/internal/udp"
 	"github.com/jota2rz/vdj-video-sync/server/internal/video"
 )
 
 func main() {
 	// ── Flags ───────────────────────────────────────────
 	port := flag.String("port", ":8090", "HTTP listen port")
+	udpAddr := flag.String("udp", "", "UDP listen address for plugin datagrams (default: same as -port, \"off\" to disable)")
+	shmPath := flag.String("shm", "", "Shared-memory ring file for a plugin on this machine (default: vdj-video-sync.ring in the temp dir, \"off\" to disable)")
 	dbPath := flag.String("db", "vdj-video-sync.db", "SQLite database path")
 	videosDir := flag.String("videos", "./videos", "Directory containing video files")
 	transitionVideosDir := flag.String("transition-videos", "./transition-videos", "Directory containing transition video files")
@@ -78,6 +82,48 @@ func main() {
 
 	// API – receives updates from VDJ plugin
 	mux.HandleFunc("POST /api/deck/update", h.HandleDeckUpdate)
+	mux.HandleFunc("POST /api/deck/batch", h.HandleDeckBatch)
+	mux.HandleFunc("GET /api/deck/ws", h.HandleDeckStream)
+	mux.HandleFunc("GET /api/ping", h.HandlePing)
+	mux.HandleFunc("GET /api/clock", h.HandleClock)
+	mux.HandleFunc("POST /api/plugin/stats", h.HandlePluginStats)
+	mux.HandleFunc("GET /api/plugin/stats", h.HandleGetPluginStats)
+	mux.HandleFunc("GET /api/plugin/subscriptions", h.HandleGetSubscriptions)
+	mux.HandleFunc("POST /api/plugin/verbs", h.HandlePluginVerbs)
+
+	// UDP – plugin datagram transport. Optional: the plugin falls back to
+	// HTTP for any frame it cannot send, so a busy port is only a warning.
+	var udpListener *udp.Listener
+	if *udpAddr != "off" {
+		addr := *udpAddr
+		if addr == "" {
+			addr = *port
+		}
+		l, err := udp.Listen(addr, h.ApplyPluginFrame)
+		if err != nil {
+			slog.Warn("UDP listener disabled", "addr", addr, "error", err)
+		} else {
+			udpListener = l
+			h.SetUDPStats(l.Stats)
+			go l.Serve()
+			slog.Info("UDP listener starting", "addr", addr)
+		}
+	}
+
+	// Shared memory – plugin ring transport when VDJ runs on this machine.
+	// The reader waits for the plugin to create the file; until it stamps
+	// its pulse the plugin keeps sending over HTTP.
+	var shmReader *shm.Reader
+	if *shmPath != "off" {
+		path := *shmPath
+		if path == "" {
+			path = shm.DefaultPath()
+		}
+		shmReader = shm.New(path, h.ApplyPluginFrame)
+		h.SetShmStats(shmReader.Stats)
+		go shmReader.Serve()
+		slog.Info("shm ring reader starting", "path", path)
+	}
 
 	// SSE – browser clients subscribe here
 	mux.HandleFunc("GET /events", h.HandleSSE)
@@ -204,6 +250,12 @@ func main() {
 	slog.Info("shutting down...")
 
 	watchCancel() // stop directory watchers
+	if udpListener != nil {
+		udpListener.Close()
+	}
+	if shmReader != nil {
+		shmReader.Close()
+	}
 
 	ctx, cancel := context.WithTimeout(context.Background(), 5*time.Second)
 	defer cancel()
@@ -267,6 +267,8 @@ class DeckSSE {
     this.overlayUpdatedListeners = [];
     /** @type {((data: object) => void)[]} */
     this.loopVideoTransitionListeners = [];
+    /** Latest subscribed VDJ verb values: { global: {verb: text}, decks: {n: {verb: text}} } */
+    this.verbValues = { global: {}, decks: {} };
     /** Last transition-pool event data (for replay on late subscribers) */
     this.lastTransitionPool = null;
     /** Cached deck visibility states (for replay on late subscribers) @type {Record<number, object>} */
@@ -321,6 +323,9 @@ class DeckSSE {
         case "loop-video-transition":
           this.loopVideoTransitionListeners.forEach((fn) => fn(data));
           break;
+        case "verb-values":
+          this.verbValues = data;
+          break;
       }
     } catch (err) {
       console.error(ts(), `[sse] ${name} parse error:`, err);
@@ -333,7 +338,7 @@ class DeckSSE {
     if (typeof SharedWorker !== "undefined") {
       // Version string forces the browser to replace a stale SharedWorker
       // when the worker script changes.  Bump on every worker code change.
-      this.worker = new SharedWorker("/static/js/sse-worker.js?v=5");
+      this.worker = new SharedWorker("/static/js/sse-worker.js?v=6");
       this.worker.port.onmessage = (e) => {
         const msg = e.data;
         if (msg.type === "open") {
@@ -376,7 +381,7 @@ class DeckSSE {
       "deck-update", "transition-pool", "transition-play",
       "deck-visibility", "analysis-status", "library-updated",
       "config-updated", "transitions-updated", "overlay-updated",
-      "loop-video-transition",
+      "loop-video-transition", "verb-values",
     ];
     for (const name of events) {
       this.source.addEventListener(name, (e) => this._dispatch(name, e.data));
@@ -1056,6 +1061,31 @@ function initDashboard() {
   // Ensure scaling runs after the flex layout has settled on first paint
   requestAnimationFrame(() => scaleDashboardVideos());
 
+  // Plugin clock: the server's offset/jitter estimate for the plugin's
+  // clock and how long deck updates take from capture to arrival.
+  function updateClockInfo() {
+    fetch("/api/plugin/stats")
+      .then((r) => r.json())
+      .then((data) => {
+        const row = document.getElementById("info-clock-row");
+        const el = document.getElementById("info-clock");
+        const c = data.clock;
+        if (!row || !el || !c) return;
+        if (!c.synced) {
+          row.classList.add("hidden");
+          return;
+        }
+        const ms = (us) => (us / 1000).toFixed(1);
+        el.textContent = `Plugin Clock: offset ${ms(c.offsetUs)} ms \u00b1${ms(c.jitterUs)} ms`
+          + ` \u00b7 drift ${c.driftPpm.toFixed(1)} ppm`
+          + ` \u00b7 latency ${ms(c.transitUs)} ms \u00b1${ms(c.transitJitterUs)} ms`;
+        row.classList.remove("hidden");
+      })
+      .catch(() => {});
+  }
+  updateClockInfo();
+  const clockInterval = setInterval(updateClockInfo, 5000);
+
   // Return cleanup function
   return () => {
     _scaleDashboardHook = null;
@@ -1063,6 +1093,7 @@ function initDashboard() {
     sse.offUpdate(updatePlayerInfoOnSSE);
     sse.offVisibility(onDeckVisibility);
     clearInterval(mirrorInterval);
+    clearInterval(clockInterval);
     window.removeEventListener('resize', onResize);
     if (cleanupEmbeddedPlayer) cleanupEmbeddedPlayer();
   };
@@ -3532,12 +3563,18 @@ function initOverlay() {
 /**
  * Execute overlay JS update functions on each element's wrapper.
  * Each element's JS is expected to be a function body that receives (el, deck, config).
+ * deck.verbs holds the subscribed VDJ verb values (global ones merged
+ * with the deck's own), keyed by verb.
  * @param {HTMLElement} container - the overlay container
  * @param {object[]} elements - array of enabled OverlayElement objects
  * @param {object} deck - the current deck state data
  */
 function runOverlayJS(container, elements, deck) {
   if (!container) return;
+  if (deck) {
+    const values = getSSE().verbValues;
+    deck = { ...deck, verbs: { ...values.global, ...(values.decks[deck.deck] || {}) } };
+  }
   for (const el of elements) {
     if (!el.js) continue;
     const wrapper = container.querySelector(`[data-overlay-key="${el.key}"]`);
@@ -27,6 +27,8 @@ const cache = {
   config: {},
   /** @type {string|null} last overlay-updated JSON */
   overlay: null,
+  /** @type {string|null} last verb-values JSON */
+  verbs: null,
 };
 
 /** Send a message to all connected ports */
@@ -61,6 +63,7 @@ function connectSSE() {
     "transitions-updated",
     "overlay-updated",
     "loop-video-transition",
+    "verb-values",
   ];
 
   for (const name of eventNames) {
@@ -87,6 +90,8 @@ function connectSSE() {
         } catch (_) {}
       } else if (name === "overlay-updated") {
         cache.overlay = e.data;
+      } else if (name === "verb-values") {
+        cache.verbs = e.data;
       }
 
       broadcast({ type: "event", name, data: e.data });
@@ -114,6 +119,9 @@ function replayTo(port) {
   if (cache.overlay) {
     port.postMessage({ type: "event", name: "overlay-updated", data: cache.overlay });
   }
+  if (cache.verbs) {
+    port.postMessage({ type: "event", name: "verb-values", data: cache.verbs });
+  }
 }
 
 // Handle new tab connections
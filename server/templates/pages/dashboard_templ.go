@@ -109,7 +109,7 @@ func DashboardContent() templ.Component {
 				return templ_7745c5c3_Err
 			}
 		}
-		templ_7745c5c3_Err = templruntime.WriteString(templ_7745c5c3_Buffer, 4, "</div></section><!-- Embedded Player Preview --><section class=\"flex-1 flex flex-col min-h-0 mt-2\"><h2 class=\"shrink-0 text-lg font-semibold mb-2 text-center\">Master Video</h2><div class=\"flex-1 flex flex-col items-center min-h-0\"><div id=\"embedded-player-wrap\" class=\"flex-1 min-h-0 w-full\" style=\"max-width:50%;\"><div id=\"embedded-player\" class=\"relative rounded-lg bg-black border border-gray-800 overflow-hidden mx-auto\" data-aspect-ratio style=\"aspect-ratio: 16/9;\"><div id=\"embedded-no-video\" class=\"absolute inset-0 flex items-center justify-center text-gray-600 text-sm\">Waiting for track...</div></div></div><div id=\"player-info\" class=\"shrink-0 mt-1 text-xs text-gray-500 text-center\"><div class=\"flex items-center justify-center gap-6\"><span id=\"info-match\">Video Match: —</span> <span id=\"info-rate\">Playback Rate: —</span> <span id=\"info-bpm\">Master BPM: —</span></div><div id=\"info-trans-row\" class=\"mt-1 hidden\"><span id=\"info-trans-rate\">Transition Playback Rate: —</span></div></div></div></section></main>")
+		templ_7745c5c3_Err = templruntime.WriteString(templ_7745c5c3_Buffer, 4, "</div></section><!-- Embedded Player Preview --><section class=\"flex-1 flex flex-col min-h-0 mt-2\"><h2 class=\"shrink-0 text-lg font-semibold mb-2 text-center\">Master Video</h2><div class=\"flex-1 flex flex-col items-center min-h-0\"><div id=\"embedded-player-wrap\" class=\"flex-1 min-h-0 w-full\" style=\"max-width:50%;\"><div id=\"embedded-player\" class=\"relative rounded-lg bg-black border border-gray-800 overflow-hidden mx-auto\" data-aspect-ratio style=\"aspect-ratio: 16/9;\"><div id=\"embedded-no-video\" class=\"absolute inset-0 flex items-center justify-center text-gray-600 text-sm\">Waiting for track...</div></div></div><div id=\"player-info\" class=\"shrink-0 mt-1 text-xs text-gray-500 text-center\"><div class=\"flex items-center justify-center gap-6\"><span id=\"info-match\">Video Match: —</span> <span id=\"info-rate\">Playback Rate: —</span> <span id=\"info-bpm\">Master BPM: —</span></div><div id=\"info-trans-row\" class=\"mt-1 hidden\"><span id=\"info-trans-rate\">Transition Playback Rate: —</span></div><div id=\"info-clock-row\" class=\"mt-1 hidden\"><span id=\"info-clock\">Plugin Clock: —</span></div></div></div></section></main>")
 		if templ_7745c5c3_Err != nil {
 			return templ_7745c5c3_Err
 		}